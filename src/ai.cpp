@@ -21,10 +21,9 @@ auto euclideanDist = [](Motion& fishMotion, Motion& turtleMotion)
 };
 
 auto checkNearbyBlobules = [](ECS::Entity e) {
-	for (ECS::Entity& blob : ECS::registry<Blobule>.entities)
+	Motion& eggMotion = ECS::registry<Motion>().get(e);
+	for (auto [blob, blobMotion, blobule] : ECS::view<Motion, Blobule>())
 	{
-		Motion& eggMotion = ECS::registry<Motion>.get(e);
-		Motion& blobMotion = ECS::registry<Motion>.get(blob);
 		if (euclideanDist(eggMotion, blobMotion) <= maxDistanceFromEgg)
 			return true;
 	}
@@ -43,14 +42,18 @@ std::shared_ptr <BTNode> SquareMovementPattern = std::make_unique<BTAndSequence>
 std::shared_ptr <BTNode> moveOrFlee = std::make_unique<BTIfElseCondition>(flee, SquareMovementPattern, checkNearbyBlobules);
 std::shared_ptr <BTNode> eggBehaviour = std::make_unique<BTRepeatingSequence>(std::vector<std::shared_ptr <BTNode>>({ moveOrFlee }));
 
+AISystem::AISystem(ECS::World& world) : world(world)
+{
+}
+
 void AISystem::step(float elapsed_ms, vec2 window_size_in_game_units)
 {
+	ECS::World::Scope scope(world);
 	(void)elapsed_ms; // placeholder to silence unused warning until implemented
 	(void)window_size_in_game_units; // placeholder to silence unused warning until implemented
 
-	for (ECS::Entity& eggNPC : ECS::registry<EggAi>.entities)
+	for (auto [eggNPC, eggAi] : ECS::view<EggAi>())
 	{
-		EggAi& eggAi = ECS::registry<EggAi>.get(eggNPC);
 		if (!eggAi.initBehaviour)
 		{
 			eggBehaviour->init(eggNPC);
@@ -10,12 +10,15 @@
 class AISystem
 {
 public:
+	// Steers the eggs of world
+	explicit AISystem(ECS::World& world = ECS::World::main());
 
 	void step(float elapsed_ms, vec2 window_size_in_game_units);
 	void updateEggAiState();
 	void EggAiActOnState();
 
 private:
+	ECS::World& world;
 	std::string lastActivePlayer;
 	int currentState;
 	ECS::Entity horse;
@@ -153,7 +153,7 @@ BTState MoveXDirection::process(ECS::Entity e) {
 	--m_stepsRemaining;
 
 	// modify world
-	auto& motion = ECS::registry<Motion>.get(e);
+	auto& motion = ECS::registry<Motion>().get(e);
 	motion.velocity.y = 0;
 	motion.velocity.x = motion.direction.x * m_speed;
 
@@ -185,7 +185,7 @@ BTState MoveYDirection::process(ECS::Entity e) {
 	--m_stepsRemaining;
 
 	// modify world
-	auto& motion = ECS::registry<Motion>.get(e);
+	auto& motion = ECS::registry<Motion>().get(e);
 	motion.velocity.x = 0;
 	motion.velocity.y = motion.direction.y * m_speed;
 
@@ -205,7 +205,7 @@ void TurnX::init(ECS::Entity e) {
 }
 
 BTState TurnX::process(ECS::Entity e) {
-	auto& motion = ECS::registry<Motion>.get(e);
+	auto& motion = ECS::registry<Motion>().get(e);
 	motion.direction.x = -motion.direction.x;
 
 	return BTState::Success;
@@ -218,7 +218,7 @@ void TurnY::init(ECS::Entity e) {
 }
 
 BTState TurnY::process(ECS::Entity e) {
-	auto& motion = ECS::registry<Motion>.get(e);
+	auto& motion = ECS::registry<Motion>().get(e);
 	motion.direction.y = -motion.direction.y;
 
 	return BTState::Success;
@@ -233,13 +233,12 @@ void Flee::init(ECS::Entity e) {
 
 BTState Flee::process(ECS::Entity e) {
 	// modify world
-	auto& motion = ECS::registry<Motion>.get(e);
+	auto& motion = ECS::registry<Motion>().get(e);
 	float angle = 0;
 	float closestDist = 1000000.f;
 
-	for (ECS::Entity blob : ECS::registry<Blobule>.entities)
+	for (auto [blob, blobMotion, blobule] : ECS::view<Motion, Blobule>())
 	{
-		Motion& blobMotion = ECS::registry<Motion>.get(blob);
 		float dist = euclideanDist(blobMotion, motion);
 		if (dist < closestDist) {
 			closestDist = dist;
@@ -35,21 +35,24 @@ ECS::Entity Blobule::createBlobule(vec2 position, blobuleCol col, std::string co
     }
     
     // Store a reference to the potentially re-used mesh object (the value is stored in the resource cache)
-    ECS::registry<ShadedMeshRef>.emplace(entity, resource);
+    ECS::registry<ShadedMeshRef>().emplace(entity, resource);
 
     // Initialize the position, scale and physics components.
     // The only relevant component is position, as the others will not be used.
-    auto& motion = ECS::registry<Motion>.emplace(entity);
+    auto& motion = ECS::registry<Motion>().emplace(entity);
     motion.angle = 0.f;
     motion.velocity = {0.f, 0.f};
     motion.position = position;
     motion.friction = 0.f;
     motion.scale = vec2({ 0.80f, 0.80f }) * vec2({ resource.texture.size.x / resource.num_columns, resource.texture.size.y / resource.num_rows });
     motion.isCollidable = true;
-    motion.shape = "circle";
+    motion.shape = Shape::circle;
+    auto& body = ECS::registry<RigidBody>().emplace(entity);
+    body.type = BodyType::Dynamic;
+    body.previous_position = position;
 
     // Create and (empty) Blobule component to be able to refer to all blobs
-    auto& blob = ECS::registry<Blobule>.emplace(entity);
+    auto& blob = ECS::registry<Blobule>().emplace(entity);
     blob.origin = position;
     blob.color = colString;
     blob.colEnum = col;
@@ -58,14 +61,14 @@ ECS::Entity Blobule::createBlobule(vec2 position, blobuleCol col, std::string co
 }
 
 void Blobule::setTrajectory(ECS::Entity entity) {
-    if (!ECS::registry<Blobule>.has(entity)) {
+    if (!ECS::registry<Blobule>().has(entity)) {
         return;
     }
-    auto& blob = ECS::registry<Blobule>.get(entity);
-    auto& trajMesh = *ECS::registry<ShadedMeshRef>.get(blob.trajectoryEntity).reference_to_cache;
+    auto& blob = ECS::registry<Blobule>().get(entity);
+    auto& trajMesh = *ECS::registry<ShadedMeshRef>().get(blob.trajectoryEntity).reference_to_cache;
 
-    auto& blobMotion = ECS::registry<Motion>.get(entity);
-    auto& trajMotion = ECS::registry<Motion>.get(blob.trajectoryEntity);
+    auto& blobMotion = ECS::registry<Motion>().get(entity);
+    auto& trajMotion = ECS::registry<Motion>().get(blob.trajectoryEntity);
 
     float powerScale = min(abs(blobMotion.dragDistance) * 0.01, 3.5);
     if (powerScale < 0.2) {
@@ -79,11 +82,11 @@ void Blobule::setTrajectory(ECS::Entity entity) {
 }
 
 void Blobule::removeTrajectory(ECS::Entity entity) {
-    if (!ECS::registry<Blobule>.has(entity)) {
+    if (!ECS::registry<Blobule>().has(entity)) {
         return;
     }
-    auto& blob = ECS::registry<Blobule>.get(entity);
-    auto& trajMotion = ECS::registry<Motion>.get(blob.trajectoryEntity);
+    auto& blob = ECS::registry<Blobule>().get(entity);
+    auto& trajMotion = ECS::registry<Motion>().get(blob.trajectoryEntity);
     trajMotion.scale = { 0.f, 0.f };
 }
 
@@ -97,7 +100,7 @@ ECS::Entity Blobule::createTrajectory(Blobule& blob) {
         RenderSystem::createSprite(resource, textures_path("dotted_line.png"), "textured");
 
     }
-    ECS::registry<ShadedMeshRef>.emplace(entity, resource);
+    ECS::registry<ShadedMeshRef>().emplace(entity, resource);
 
     // Change color of dotted line based on enum?
     switch (blob.colEnum) {
@@ -113,10 +116,31 @@ ECS::Entity Blobule::createTrajectory(Blobule& blob) {
         break;
     }
 
-    auto& trajectoryMotion = ECS::registry<Motion>.emplace(entity);
+    auto& trajectoryMotion = ECS::registry<Motion>().emplace(entity);
     trajectoryMotion.scale = { 0.f, 0.f };
     trajectoryMotion.isCollidable = false;
 
     return entity;
 }
 
+void ECS::Serializer<Blobule>::write(ECS::SnapshotWriter& out, const Blobule& blob)
+{
+	out.write(blob.origin);
+	out.write(blob.currentGrid);
+	out.write(blob.color);
+	out.write(blob.colEnum);
+	out.write(blob.active_player);
+	out.write(blob.trajectoryEntity);
+}
+
+Blobule ECS::Serializer<Blobule>::read(ECS::SnapshotReader& in)
+{
+	Blobule blob;
+	in.read(blob.origin);
+	in.read(blob.currentGrid);
+	in.read(blob.color);
+	in.read(blob.colEnum);
+	in.read(blob.active_player);
+	in.read(blob.trajectoryEntity);
+	return blob;
+}
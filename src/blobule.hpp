@@ -19,7 +19,7 @@ struct Blobule
 	blobuleCol colEnum;
 	bool active_player = false;
 
-	ECS::Entity trajectoryEntity;
+	ECS::Entity trajectoryEntity = ECS::Entity::null();
 	// Create all the associated render resources and default transform.
 	static ECS::Entity createBlobule(vec2 position, blobuleCol col, std::string colString);
 
@@ -32,3 +32,10 @@ private:
 
 };
 
+template <> struct ECS::Serializer<Blobule>
+{
+	static constexpr bool available = true;
+	static void write(ECS::SnapshotWriter& out, const Blobule& blob);
+	static Blobule read(ECS::SnapshotReader& in);
+};
+
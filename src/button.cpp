@@ -68,18 +68,18 @@ ECS::Entity Button::createButton(vec2 position, vec2 scale, ButtonEnum buttonEnu
         RenderSystem::createSprite(resource, path, "textured");
     }
     // Store a reference to the potentially re-used mesh object (the value is stored in the resource cache)
-    ECS::registry<ShadedMeshRef>.emplace(entity, resource);
+    ECS::registry<ShadedMeshRef>().emplace(entity, resource);
 
     // Initialize the position, scale and physics components.
     // The only relevant component is position, as the others will not be used.
-    auto& motion = ECS::registry<Motion>.emplace(entity);
+    auto& motion = ECS::registry<Motion>().emplace(entity);
     motion.angle = 0.f;
     motion.velocity = {0.f, 0.f};
     motion.position = position;
     motion.friction = 0.f;
     motion.scale = scale * static_cast<vec2>(resource.texture.size);
 
-    auto& button = ECS::registry<Button>.emplace(entity);
+    auto& button = ECS::registry<Button>().emplace(entity);
     createButtonText(button, motion.position, buttonEnum, buttonText);
 
     return entity;
@@ -24,6 +24,6 @@ struct Button
 {
 	// Create all the associated render resources and default transform.
 	static ECS::Entity createButton(vec2 position, vec2 scale, ButtonEnum buttonEnum, std::string buttonstring);
-	ECS::Entity text_entity;
+	ECS::Entity text_entity = ECS::Entity::null();
 };
 
@@ -9,9 +9,13 @@
 #include "map_loader.hpp";
 #include <egg.hpp>
 #include <iostream>
+#include <array>
+#include <initializer_list>
+#include <type_traits>
 #include "debug.hpp"
 
-const float SPEED_BOOST = 50.f;
+// Added on every simulation step the blobule is on a speed tile, scaled such that the boost per second does not depend on the step length
+const float SPEED_BOOST = 50.f * simulation_step_ms / tuned_step_ms;
 
 void circle_circle_penetration_free_collision(Motion& blobMotion1, Motion& blobMotion2)
 {
@@ -49,77 +53,42 @@ void circle_circle_penetration_free_collision(Motion& blobMotion1, Motion& blobM
 	}
 }
 
-void circle_square_penetration_free_collision(Motion& blobMotion, Motion& tileMotion)
+// Moves the body back along its velocity until it penetrates the tile by at most 1 px.
+// Solved in one go by sweeping a slightly smaller circle from behind the tile towards the body's position.
+void push_back_along_velocity(Motion& bodyMotion, const Motion& tileMotion, float radius)
 {
-	if (blobMotion.velocity.x == 0 && blobMotion.velocity.y == 0)
+	if (bodyMotion.velocity.x == 0 && bodyMotion.velocity.y == 0)
 	{
 		return;
 	}
 
-	float leftEdge = tileMotion.position.x - tileMotion.scale.x / 2;
-	float rightEdge = tileMotion.position.x + tileMotion.scale.x / 2;
-	float topEdge = tileMotion.position.y - tileMotion.scale.y / 2;
-	float bottomEdge = tileMotion.position.y + tileMotion.scale.y / 2;
-
-	float closestX = glm::max(leftEdge, glm::min(blobMotion.position.x, rightEdge));
-	float closestY = glm::max(topEdge, glm::min(blobMotion.position.y, bottomEdge));
-
-	vec2 dist = vec2(blobMotion.position.x - closestX, blobMotion.position.y - closestY);
-
-	float penetrationDepth = blobMotion.scale.x / 2 - glm::length(dist);
-	const vec2 reverseUnitVel = -(blobMotion.velocity / glm::length(blobMotion.velocity));
-	while (penetrationDepth > 1)
-	{
-		float shiftX = blobMotion.position.x + reverseUnitVel.x * 2;
-		float shiftY = blobMotion.position.y + reverseUnitVel.y * 2;
-		blobMotion.position = vec2(shiftX, shiftY);
-		closestX = glm::max(leftEdge, glm::min(blobMotion.position.x, rightEdge));
-		closestY = glm::max(topEdge, glm::min(blobMotion.position.y, bottomEdge));
-		dist = vec2(blobMotion.position.x - closestX, blobMotion.position.y - closestY);
-		penetrationDepth = blobMotion.scale.x / 2 - glm::length(dist);
-	}
-}
-
-void egg_square_penetration_free_collision(Motion& blobMotion, Motion& tileMotion, Direction dir)
-{
-	if (blobMotion.velocity.x == 0 && blobMotion.velocity.y == 0)
+	const vec2 tileHalf = abs(tileMotion.scale) / 2.f;
+	const vec2 closest = glm::clamp(bodyMotion.position, tileMotion.position - tileHalf, tileMotion.position + tileHalf);
+	if (radius - glm::length(bodyMotion.position - closest) <= 1.f)
 	{
 		return;
 	}
 
-	float leftEdge = tileMotion.position.x - tileMotion.scale.x / 2;
-	float rightEdge = tileMotion.position.x + tileMotion.scale.x / 2;
-	float topEdge = tileMotion.position.y - tileMotion.scale.y / 2;
-	float bottomEdge = tileMotion.position.y + tileMotion.scale.y / 2;
-
-	float closestX = glm::max(leftEdge, glm::min(blobMotion.position.x, rightEdge));
-	float closestY = glm::max(topEdge, glm::min(blobMotion.position.y, bottomEdge));
+	const vec2 reverseUnitVel = -(bodyMotion.velocity / glm::length(bodyMotion.velocity));
+	// Far enough back that the circle cannot overlap the tile there
+	const vec2 outside = bodyMotion.position + reverseUnitVel * (radius + 2.f * glm::length(tileHalf));
 
-	vec2 dist = vec2(blobMotion.position.x - closestX, blobMotion.position.y - closestY);
-
-	float scale = 0;
-	if (dir == Direction::Left || dir == Direction::Right)
+	float toi;
+	if (Utils::sweepCircleAabb(outside, bodyMotion.position, radius - 1.f, tileMotion.position - tileHalf, tileMotion.position + tileHalf, toi))
 	{
-		scale = blobMotion.scale.x;
-	}
-	else {
-		scale = blobMotion.scale.y;
+		bodyMotion.position = outside + toi * (bodyMotion.position - outside);
 	}
+}
 
-	float penetrationDepth = scale / 2 - glm::length(dist);
-	const vec2 reverseUnitVel = -(blobMotion.velocity / glm::length(blobMotion.velocity));
-	
-	while (penetrationDepth > 1)
-	{
-		float shiftX = blobMotion.position.x + reverseUnitVel.x * 2;
-		float shiftY = blobMotion.position.y + reverseUnitVel.y * 2;
-		blobMotion.position = vec2(shiftX, shiftY);
-		closestX = glm::max(leftEdge, glm::min(blobMotion.position.x, rightEdge));
-		closestY = glm::max(topEdge, glm::min(blobMotion.position.y, bottomEdge));
-		dist = vec2(blobMotion.position.x - closestX, blobMotion.position.y - closestY);
-		penetrationDepth = scale / 2 - glm::length(dist);
-	}
+void circle_square_penetration_free_collision(Motion& blobMotion, Motion& tileMotion)
+{
+	push_back_along_velocity(blobMotion, tileMotion, blobMotion.scale.x / 2);
+}
 
+// Moves the egg out of the tile along the axis of least penetration of its hull, as found by the narrowphase
+void egg_square_penetration_free_collision(Motion& eggMotion, const Penetration& penetration)
+{
+	eggMotion.position += penetration.normal * penetration.depth;
 }
 
 float circle_circle_complex_collision_resolution(Motion& blobMotion1, Motion& blobMotion2)
@@ -187,30 +156,77 @@ void circle_square_complex_collision_handling(Motion& blobMotion, Motion& tileMo
 	blobMotion.velocity = { cos(angle) * blobMagnitude, sin(angle) * blobMagnitude };
 }
 
-void circleCircleHandleDebug(Motion& blobMotion1, Motion& blobMotion2, float angle)
+// The debug lines are entities of their own, created on flush where the bodies were at the collision
+void circleCircleHandleDebug(const Motion& blobMotion1, const Motion& blobMotion2, float angle, ECS::CommandBuffer& commands)
 {
 	// adding collision debug box
 	if (DebugSystem::in_debug_mode)
 	{
-		DebugSystem::createBox(blobMotion1.position, blobMotion1.scale, angle);
-		DebugSystem::createBox(blobMotion2.position, blobMotion2.scale, angle);
-		DebugSystem::createDirectionLine(blobMotion1.position, blobMotion1.velocity, blobMotion1.scale);
-		DebugSystem::createDirectionLine(blobMotion2.position, blobMotion2.velocity, blobMotion2.scale);
+		commands.defer([blobMotion1, blobMotion2, angle]() {
+			DebugSystem::createBox(blobMotion1.position, blobMotion1.scale, angle);
+			DebugSystem::createBox(blobMotion2.position, blobMotion2.scale, angle);
+			DebugSystem::createDirectionLine(blobMotion1.position, blobMotion1.velocity, blobMotion1.scale);
+			DebugSystem::createDirectionLine(blobMotion2.position, blobMotion2.velocity, blobMotion2.scale);
+		});
 	}
 }
 
-void circleSquareHandleDebug(Motion& blobMotion, Motion& tileMotion)
+void circleSquareHandleDebug(const Motion& blobMotion, const Motion& tileMotion, ECS::CommandBuffer& commands)
 {
 	if (DebugSystem::in_debug_mode)
 	{
-		DebugSystem::createBox(blobMotion.position, blobMotion.scale, 0.f);
-		DebugSystem::createBox(tileMotion.position, tileMotion.scale, 0.f);
-		DebugSystem::createDirectionLine(blobMotion.position, blobMotion.velocity, blobMotion.scale);
+		commands.defer([blobMotion, tileMotion]() {
+			DebugSystem::createBox(blobMotion.position, blobMotion.scale, 0.f);
+			DebugSystem::createBox(tileMotion.position, tileMotion.scale, 0.f);
+			DebugSystem::createDirectionLine(blobMotion.position, blobMotion.velocity, blobMotion.scale);
+		});
 	}
 }
 
 
+// Adapts collision logic for one contact to a handler for a whole queue of them, calling it for the contacts of the given phases.
+// By default that is every step the entities touch. Logic takes (entity, entity_other, dir), or the whole contact if it needs more.
+template <typename Event, typename Logic>
+EventBus::Handler<Event> on_contacts(Logic logic, std::initializer_list<ContactPhase> phases = { ContactPhase::begin, ContactPhase::stay })
+{
+	std::array<bool, 3> listens = { false, false, false };
+	for (ContactPhase phase : phases)
+		listens[static_cast<int>(phase)] = true;
+	return [logic, listens](const std::vector<Event>& contacts) {
+		for (const Event& contact : contacts)
+		{
+			if (!listens[static_cast<int>(contact.phase)])
+				continue;
+			if constexpr (std::is_invocable<Logic, const Event&>::value)
+				logic(contact);
+			else
+				logic(contact.entity, contact.other, contact.direction);
+		}
+	};
+}
+
+// Adapts terrain logic for one body to a handler for a whole queue of terrain samples.
+// Bodies that an earlier handler moved off the sampled tile (water, teleports) are skipped.
+template <typename Event, typename Logic>
+EventBus::Handler<Event> on_terrain(Logic logic)
+{
+	return [logic](const std::vector<Event>& samples) {
+		auto& motion_container = ECS::registry<Motion>();
+		for (const Event& sample : samples)
+		{
+			const vec2 offset = abs(motion_container.get(sample.entity).position - motion_container.get(sample.tile).position);
+			if (offset.x <= tileSize / 2.f && offset.y <= tileSize / 2.f)
+				logic(sample.entity, sample.tile);
+		}
+	};
+}
+
+CollisionSystem::CollisionSystem(ECS::World& world) : world(world)
+{
+}
+
 void CollisionSystem::initialize_collisions() {
+    ECS::World::Scope scope(world);
     
     // Audio initialization.
     collision_sound = Mix_LoadWAV(audio_path("collision.wav").c_str());
@@ -223,40 +239,29 @@ void CollisionSystem::initialize_collisions() {
             audio_path("splash.wav")+
             audio_path("powerup.wav"));
 
-	//observer for blobule - tile collision
-	blobule_tile_coll = ECS::registry<Subject>.get(Subject::createSubject("blobule_tile_coll"));
-	// observer for blobule - blobule collision (circle-circle)
-	blobule_blobule_coll = ECS::registry<Subject>.get(Subject::createSubject("blobule_blobule_coll"));
-	// observer for blobule - egg collision (circle-preciseCollision)
-	blobule_egg_coll = ECS::registry<Subject>.get(Subject::createSubject("blobule_egg_coll"));
-
-	egg_tile_coll = ECS::registry<Subject>.get(Subject::createSubject("egg_tile_coll"));
-
-	//Add any collision logic here as a lambda function that takes in (entity, entity_other)
-	auto blob_blob_collision = [this](auto entity, auto entity_other, Direction dir) {
-        
-        // Play collision_sound.
-        Mix_PlayChannel(-1, collision_sound, 0);
-        
+	//Add any collision logic here as a lambda function that takes in (entity, entity_other, dir), and subscribe it below
+	auto blob_blob_collision = [this](auto entity, auto entity_other, Direction) {
 		// entity_other is colliding with entity
-		auto& blobMotion1 = ECS::registry<Motion>.get(entity);
-		auto& blobMotion2 = ECS::registry<Motion>.get(entity_other);
+		auto& blobMotion1 = ECS::registry<Motion>().get(entity);
+		auto& blobMotion2 = ECS::registry<Motion>().get(entity_other);
 
 		float derivedAngle = circle_circle_complex_collision_resolution(blobMotion1, blobMotion2);
 		circle_circle_penetration_free_collision(blobMotion1, blobMotion2);
 		
-		circleCircleHandleDebug(blobMotion1, blobMotion2, derivedAngle);
-        // Play collision_sound.
+		circleCircleHandleDebug(blobMotion1, blobMotion2, derivedAngle, *commands);
+	};
+
+	auto play_collision_sound = [this](auto, auto, Direction) {
         Mix_PlayChannel(-1, collision_sound, 0);
 	};
 
 
 	auto blobule_tile_interaction = [this](auto entity, auto entity_other, Direction dir) {
 		//subject tile to wall
-		auto& blob = ECS::registry<Blobule>.get(entity);
-		auto& blobMotion = ECS::registry<Motion>.get(entity);
-		auto& terrain = ECS::registry<Terrain>.get(entity_other);
-		auto& tileMotion = ECS::registry<Motion>.get(entity_other);
+		auto& blob = ECS::registry<Blobule>().get(entity);
+		auto& blobMotion = ECS::registry<Motion>().get(entity);
+		auto& terrain = ECS::registry<Terrain>().get(entity_other);
+		auto& tileMotion = ECS::registry<Motion>().get(entity_other);
 
 		if (terrain.type == Water) {
             // Play splash_sound.
@@ -264,9 +269,26 @@ void CollisionSystem::initialize_collisions() {
             
 			blobMotion.velocity = { 0.f, 0.f };
 			blobMotion.friction = 0.f;
-			blobMotion.position = blob.origin;
+			Utils::placeBody(entity, blob.origin);
+		}
+		else if (terrain.type == Block)
+		{
+			// pen free must go before complex collision or errors will occur
+			circle_square_penetration_free_collision(blobMotion, tileMotion);
+			circle_square_complex_collision_handling(blobMotion, tileMotion, dir);
+
+			circleSquareHandleDebug(blobMotion, tileMotion, *commands);
+			
+            Mix_PlayChannel(-1, collision_sound, 0);
 		}
-        else if (terrain.type == Speed) {
+	};
+
+	// Effects of the tile under the blobule's center, applied every step it is there
+	auto blobule_terrain_effects = [](auto entity, auto tile) {
+		auto& blobMotion = ECS::registry<Motion>().get(entity);
+		auto& terrain = ECS::registry<Terrain>().get(tile);
+
+        if (terrain.type == Speed) {
             // Check for positive and negative x-velocity.
             if (blobMotion.velocity.x >= 0){
                 blobMotion.velocity = {blobMotion.velocity.x + SPEED_BOOST,  blobMotion.velocity.y};
@@ -305,25 +327,18 @@ void CollisionSystem::initialize_collisions() {
         }
         else if (terrain.type == Teleport) {
 
-			vec2 difference_between_centers = tileMotion.position - blobMotion.position;
-			float distance_between_centers = std::sqrt(dot(difference_between_centers, difference_between_centers));
-			float blobMotion_hit_radius = blobMotion.scale.x / 1.3f;
-			if (distance_between_centers > blobMotion_hit_radius) {
-				return;
-			}
-
-			ECS::Entity teleportDestination = entity_other;
-			int size = ECS::registry<Teleporting>.size();
+			ECS::Entity teleportDestination = tile;
+			int size = ECS::registry<Teleporting>().size();
 
 			if (size <= 1) {
 				return;
 			}
 
-			while (entity_other.id == teleportDestination.id && size > 1) {
-				teleportDestination = ECS::registry<Teleporting>.entities[(rand() % size)];
+			while (tile.id == teleportDestination.id && size > 1) {
+				teleportDestination = ECS::registry<Teleporting>().entities[(rand() % size)];
 			}
 
-			blobMotion.position = ECS::registry<Motion>.get(teleportDestination).position;
+			blobMotion.position = ECS::registry<Motion>().get(teleportDestination).position;
 
 			// Adjusting horizontal position after teleportation.
 			if (blobMotion.velocity.x >= 0) {
@@ -340,117 +355,130 @@ void CollisionSystem::initialize_collisions() {
 			else {
 				blobMotion.position.y -= 23.f;
 			}
+			// Drawn at the destination right away, not interpolated across the island
+			Utils::placeBody(entity, blobMotion.position);
         }
-		else if (terrain.type == Block)
-		{
-			// pen free must go before complex collision or errors will occur
-			circle_square_penetration_free_collision(blobMotion, tileMotion);
-			circle_square_complex_collision_handling(blobMotion, tileMotion, dir);
-
-			circleSquareHandleDebug(blobMotion, tileMotion);
-			
-            Mix_PlayChannel(-1, collision_sound, 0);
-		}
-		else {
+		else if (terrain.type != Block && terrain.type != Water) {
 			blobMotion.friction = terrain.friction;
 		}
 	};
 
-	auto change_tile_color = [](auto entity, auto entity_other, Direction dir) {
-        auto& terrain = ECS::registry<Terrain>.get(entity_other);
-        if (terrain.type != Speed_UP && terrain.type != Speed_LEFT && terrain.type != Speed_RIGHT && terrain.type != Speed_DOWN && terrain.type != Speed && terrain.type != Teleport){
-            auto tileMotion = ECS::registry<Motion>.get(entity_other);
-            auto blobMotion = ECS::registry<Motion>.get(entity);
-            vec2 difference_between_centers = tileMotion.position - blobMotion.position;
-            float distance_between_centers = std::sqrt(dot(difference_between_centers, difference_between_centers));
-            float blobMotion_hit_radius = blobMotion.scale.x / 1.3f;
-            if (distance_between_centers <= blobMotion_hit_radius) {
-                auto& blob = ECS::registry<Blobule>.get(entity);
-                Tile::setSplat(entity_other, blob.colEnum);
-				blob.currentGrid = ECS::registry<Tile>.get(entity_other).gridLocation;
-            }
-        }
+	// Paints the tile under the blobule's center once it gets there
+	auto change_tile_color = [this](auto entity, auto tile) {
+		auto& gridLocation = ECS::registry<Tile>().get(tile).gridLocation;
+		// The water around the island is not on the grid, and currentGrid is saved with the map
+		if (gridLocation[0] == -1 && gridLocation[1] == -1)
+			return;
+		auto& blob = ECS::registry<Blobule>().get(entity);
+		blob.currentGrid = gridLocation;
+		// Repaints the tile whenever it shows another color, also after another blobule painted the tile it rests on
+		auto& terrain = ECS::registry<Terrain>().get(tile);
+		if (terrain.type != Speed_UP && terrain.type != Speed_LEFT && terrain.type != Speed_RIGHT && terrain.type != Speed_DOWN && terrain.type != Speed && terrain.type != Teleport
+			&& !Tile::hasSplat(tile, blob.colEnum)) {
+			// Replaces the splat's components, and its texture is created on first use
+			commands->defer([tile, color = blob.colEnum]() { Tile::setSplat(tile, color); });
+		}
 	};
 
-	auto egg_tile_interaction = [](auto entity, auto entity_other, Direction dir) {
+	auto egg_tile_interaction = [](const EggTileContact& contact) {
 
-		auto& eggMotion = ECS::registry<Motion>.get(entity);
-		auto& tileMotion = ECS::registry<Motion>.get(entity_other);
-		auto& terrain = ECS::registry<Terrain>.get(entity_other);
+		auto& eggMotion = ECS::registry<Motion>().get(contact.entity);
+		const Direction dir = contact.direction;
 
-		if (terrain.type == Water || terrain.type == Block)
-		{
-			egg_square_penetration_free_collision(eggMotion, tileMotion, dir);
+		// Eggs only touch Water and Block tiles, and bounce off both
+		egg_square_penetration_free_collision(eggMotion, contact.penetration);
 
-			if (dir == Direction::Top || dir == Direction::Bottom)
-			{
-				eggMotion.velocity.y = -eggMotion.velocity.y;
-				eggMotion.direction.y = -eggMotion.direction.y;
-			}
-			else if (dir == Direction::Left || dir == Direction::Right)
-			{
-				eggMotion.velocity.x = -eggMotion.velocity.x;
-				eggMotion.direction.x = -eggMotion.direction.x;
-			}
+		if (dir == Direction::Top || dir == Direction::Bottom)
+		{
+			eggMotion.velocity.y = -eggMotion.velocity.y;
+			eggMotion.direction.y = -eggMotion.direction.y;
 		}
-		else {
-			auto& egg = ECS::registry<Egg>.get(entity);
-			egg.gridLocation = ECS::registry<Tile>.get(entity_other).gridLocation;
+		else if (dir == Direction::Left || dir == Direction::Right)
+		{
+			eggMotion.velocity.x = -eggMotion.velocity.x;
+			eggMotion.direction.x = -eggMotion.direction.x;
 		}
 	};
 
+	auto egg_terrain = [](auto entity, auto tile) {
+		auto& egg = ECS::registry<Egg>().get(entity);
+		egg.gridLocation = ECS::registry<Tile>().get(tile).gridLocation;
+	};
+
 	// egg disappears on collision with blob (only use the second param)
-	auto remove_egg = [this](auto entity, auto eggEntity, Direction dir) {
+	auto remove_egg = [this](auto entity, auto eggEntity, Direction) {
+		// Several blobules can reach the same egg in one step, only the first one collects it
+		if (commands->is_destroyed(eggEntity))
+			return;
         // Play splash_sound.
         Mix_PlayChannel(-1, powerup_sound, 0);
-		ECS::ContainerInterface::remove_all_components_of(eggEntity);
-		PowerupSystem::Powerup::createPowerup(entity);
+		// Deferred, the egg's own collisions are still being iterated
+		commands->destroy(eggEntity);
+		PowerupSystem::Powerup::createPowerup(entity, *commands);
 	};
 
-	//add lambdas to the observer lists
-	blobule_tile_coll.add_observer(blobule_tile_interaction);
-	blobule_tile_coll.add_observer(change_tile_color);
-	blobule_blobule_coll.add_observer(blob_blob_collision);
-	blobule_egg_coll.add_observer(remove_egg);
-	egg_tile_coll.add_observer(egg_tile_interaction);
+	//subscribe the lambdas to the contacts they handle
+	events.subscribe<BlobuleTileContact>(on_contacts<BlobuleTileContact>(blobule_tile_interaction));
+	events.subscribe<BlobuleBlobuleContact>(on_contacts<BlobuleBlobuleContact>(blob_blob_collision));
+	events.subscribe<BlobuleBlobuleContact>(on_contacts<BlobuleBlobuleContact>(play_collision_sound, { ContactPhase::begin }));
+	events.subscribe<BlobuleEggContact>(on_contacts<BlobuleEggContact>(remove_egg, { ContactPhase::begin }));
+	events.subscribe<EggTileContact>(on_contacts<EggTileContact>(egg_tile_interaction));
+	events.subscribe<BlobuleTerrain>(on_terrain<BlobuleTerrain>(blobule_terrain_effects));
+	events.subscribe<BlobuleTerrain>(on_terrain<BlobuleTerrain>(change_tile_color));
+	events.subscribe<EggTerrain>(on_terrain<EggTerrain>(egg_terrain));
 }
+
 // Compute collisions between entities
-void CollisionSystem::handle_collisions()
+void CollisionSystem::handle_collisions(const ContactBuffer& contacts, const std::vector<TerrainSample>& terrain, ECS::CommandBuffer& commands)
 {
-	// Loop over all collisions detected by the physics system
-	auto& registry = ECS::registry<PhysicsSystem::Collision>;
-	for (unsigned int i = 0; i < registry.components.size(); i++)
+	ECS::World::Scope scope(world);
+	this->commands = &commands;
+	// Sort the contacts detected by the physics system in the last step by kind
+	for (const auto& contact : contacts.contacts())
 	{
-		auto& collision = registry.components[i];
 		// The entity and its collider
-		auto entity = registry.entities[i];
-		auto entity_other = collision.other;
+		auto entity = contact.entity;
+		auto entity_other = contact.other;
+		// Contacts that ended can refer to entities destroyed since
+		if (!ECS::valid(entity) || !ECS::valid(entity_other))
+			continue;
 
 		// Blobule collisions
-		if (ECS::registry<Blobule>.has(entity)) {
-			// Change friction of blobule based on which tile it is on
-			if (ECS::registry<Tile>.has(entity_other)) {
-				blobule_tile_coll.notify(entity, entity_other, collision.direction);
+		if (ECS::registry<Blobule>().has(entity)) {
+			// Blobule - wall collisions
+			if (ECS::registry<Tile>().has(entity_other)) {
+				events.publish(BlobuleTileContact{ contact });
 			}
 
 			// Blobule - blobule collisions
-			if (ECS::registry<Blobule>.has(entity_other)) {
-				blobule_blobule_coll.notify(entity, entity_other, collision.direction);
+			if (ECS::registry<Blobule>().has(entity_other)) {
+				events.publish(BlobuleBlobuleContact{ contact });
 			}
 
 			// blobule - egg collisions
-			if (ECS::registry<Egg>.has(entity_other)) {
-				blobule_egg_coll.notify(entity, entity_other, collision.direction);
+			if (ECS::registry<Egg>().has(entity_other)) {
+				events.publish(BlobuleEggContact{ contact });
 			}
 		}
 
 		// Egg - collisions
-		else if (ECS::registry<Egg>.has(entity)) {
-			if (ECS::registry<Tile>.has(entity_other)) {
-				egg_tile_coll.notify(entity, entity_other, collision.direction);
+		else if (ECS::registry<Egg>().has(entity)) {
+			if (ECS::registry<Tile>().has(entity_other)) {
+				events.publish(EggTileContact{ contact });
 			}
 		}
 	}
-	// Remove all collisions from this simulation step
-	ECS::registry<PhysicsSystem::Collision>.clear();
+	// The terrain under each body, after the contacts such that walls already pushed the bodies back
+	for (const auto& sample : terrain)
+	{
+		if (!ECS::valid(sample.entity) || !ECS::valid(sample.tile))
+			continue;
+		if (ECS::registry<Blobule>().has(sample.entity))
+			events.publish(BlobuleTerrain{ sample });
+		else if (ECS::registry<Egg>().has(sample.entity))
+			events.publish(EggTerrain{ sample });
+	}
+	// Each kind of contact is handled in one pass over its queue
+	events.dispatch();
+	this->commands = nullptr;
 }
@@ -1,24 +1,41 @@
 #pragma once
 
 #include "common.hpp"
-#include "subject.hpp"
+#include "events.hpp"
+#include "physics.hpp"
 #include "tiny_ecs.hpp"
 
 #define SDL_MAIN_HANDLED
 #include <SDL.h>
 #include <SDL_mixer.h>
 
+// The contacts of the last physics step by the kinds of entities involved, entity is always the first kind
+struct BlobuleTileContact : ContactBuffer::Contact {};
+struct BlobuleBlobuleContact : ContactBuffer::Contact {};
+struct BlobuleEggContact : ContactBuffer::Contact {};
+struct EggTileContact : ContactBuffer::Contact {};
+// The tile under a body's center
+struct BlobuleTerrain : TerrainSample {};
+struct EggTerrain : TerrainSample {};
+
 class CollisionSystem
 {
 public: 
+    // Handles the contacts between the entities of world
+    explicit CollisionSystem(ECS::World& world = ECS::World::main());
+
     void initialize_collisions();
-    void handle_collisions();
+    // Structural changes, e.g., collected eggs and painted tiles, are recorded into commands
+    void handle_collisions(const ContactBuffer& contacts, const std::vector<TerrainSample>& terrain, ECS::CommandBuffer& commands);
 
 private:
-    Subject blobule_tile_coll;
-    Subject blobule_blobule_coll;
-    Subject blobule_egg_coll;
-    Subject egg_tile_coll;
+    ECS::World& world;
+
+    // Queues the contacts by kind, the collision logic subscribes to the kinds it handles
+    EventBus events;
+
+    // Where the observers record their structural changes while handle_collisions runs
+    ECS::CommandBuffer* commands = nullptr;
     
     // Music References
     Mix_Chunk* collision_sound;
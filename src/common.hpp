@@ -17,10 +17,19 @@
 #include <glm/vec3.hpp>             // vec3
 #include <glm/mat3x3.hpp>           // mat3
 using namespace glm;
+
+// internal
+#include "tiny_ecs.hpp"
+
 static const float PI = 3.14159265359f;
 
 static const float tileSize = 45.f;
 
+// The simulation advances in fixed steps of this length, independent of the frame rate
+static const float simulation_step_ms = 1000.f / 120.f;
+// Per-step gameplay constants (friction, speed tile boosts) were tuned at this step length
+static const float tuned_step_ms = 1000.f / 60.f;
+
 // Simple utility functions to avoid mistyping directory name
 inline std::string data_path() { return "data"; };
 inline std::string shader_path(const std::string& name) { return data_path() + "/shaders/" + name;};
@@ -37,6 +46,10 @@ struct Transform {
 	void translate(vec2 offset);
 };
 
+// Collision shape of a Motion, see the collision dispatch table in physics.cpp
+enum class Shape { square, circle, egg };
+static const int SHAPE_COUNT = 3;
+
 // All data relevant to the shape and motion of entities
 struct Motion {
 	vec2 position = { 0, 0 };
@@ -47,9 +60,22 @@ struct Motion {
 	vec2 direction = { 0, 0 };
 	vec2 scale = { 0, 0 };
 	bool isCollidable = false;
-	std::string shape = "square";
+	Shape shape = Shape::square;
 };
 
+// Entities that move by their Motion velocity, everything else (tiles, splats, UI) is never integrated
+enum class BodyType { Kinematic, Dynamic };
+struct RigidBody {
+	// Dynamic bodies slow down by their Motion friction and come to rest below the terminal velocity,
+	// kinematic bodies keep whatever velocity their system gives them
+	BodyType type = BodyType::Dynamic;
+	// Position before the last simulation step, rendering interpolates from here to the Motion position
+	vec2 previous_position = { 0, 0 };
+};
+
+// Tiles hold on to their Motion while creating the splat's, chunked storage keeps such references valid when the container grows
+template <> struct ECS::StoragePolicy<Motion> { using type = ECS::ChunkedVector<Motion>; };
+
 // active player shared as global variable
 
 enum class EggState { normal, move };
@@ -7,6 +7,17 @@
 #include <iostream>
 
 #include "render_components.hpp"
+#include "text.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
 
 // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 // DON'T WORRY ABOUT THIS CLASS UNTIL ASSIGNMENT 2
@@ -50,24 +61,22 @@ namespace DebugSystem
 		}
 
 		// Store a reference to the potentially re-used mesh object (the value is stored in the resource cache)
-		ECS::registry<ShadedMeshRef>.emplace(entity, resource);
+		ECS::registry<ShadedMeshRef>().emplace(entity, resource);
 
 		// Create motion
-		auto& motion = ECS::registry<Motion>.emplace(entity);
+		auto& motion = ECS::registry<Motion>().emplace(entity);
 		motion.angle = angle;
 		motion.velocity = { 0, 0 };
 		motion.position = position;
 		motion.scale = scale;
 		motion.isCollidable = false;
 
-		ECS::registry<DebugComponent>.emplace(entity);
+		ECS::registry<DebugComponent>().emplace(entity);
 	}
 
 	void clearDebugComponents() {
 		// Clear old debugging visualizations
-		while (ECS::registry<DebugComponent>.entities.size() > 0) {
-			ECS::ContainerInterface::remove_all_components_of(ECS::registry<DebugComponent>.entities.back());
-        }
+		ECS::ContainerInterface::destroy_entities(ECS::registry<DebugComponent>().marked_entities());
 	}
 
 	void createBox(vec2 position, vec2 size, float angle)
@@ -137,4 +146,101 @@ namespace DebugSystem
 	}
 
 	bool in_debug_mode = false;
+
+	// typeid names are mangled on gcc and clang
+	static std::string readableTypeName(const char* name)
+	{
+#ifdef __GNUG__
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+		if (status == 0 && demangled) {
+			std::string result = demangled;
+			std::free(demangled);
+			return result;
+		}
+#endif
+		return name;
+	}
+
+	// Largest containers first
+	static std::vector<ECS::ContainerStats> sortedComponentStats()
+	{
+		auto stats = ECS::ContainerInterface::collect_stats();
+		std::sort(stats.begin(), stats.end(), [](const ECS::ContainerStats& a, const ECS::ContainerStats& b) { return a.bytes_reserved > b.bytes_reserved; });
+		return stats;
+	}
+
+	std::string componentStatsJson()
+	{
+		nlohmann::json containers = nlohmann::json::array();
+		for (const auto& stats : sortedComponentStats()) {
+			containers.push_back({
+				{ "type", readableTypeName(stats.type_name) },
+				{ "count", stats.count },
+				{ "peak_count", stats.peak_count },
+				{ "bytes_used", stats.bytes_used },
+				{ "bytes_reserved", stats.bytes_reserved },
+				{ "index_load_factor", stats.index_load_factor },
+				{ "inserts_last_frame", stats.inserts_last_frame },
+				{ "removes_last_frame", stats.removes_last_frame }
+			});
+		}
+		nlohmann::json result;
+		result["frame"] = ECS::current_frame();
+		result["containers"] = containers;
+		return result.dump(4);
+	}
+
+	void saveComponentStats(const std::string& path)
+	{
+		std::ofstream file(path);
+		file << componentStatsJson();
+		std::cout << "Saved component statistics to " << path << std::endl;
+	}
+
+	void printComponentStats()
+	{
+		std::cout << "Component containers (count / peak, KiB used / reserved, index load):\n";
+		for (const auto& stats : sortedComponentStats()) {
+			if (stats.peak_count == 0)
+				continue;
+			std::cout << "  " << std::left << std::setw(32) << readableTypeName(stats.type_name) << std::right
+				<< std::setw(7) << stats.count << " / " << std::setw(7) << stats.peak_count
+				<< std::setw(9) << stats.bytes_used / 1024 << " / " << std::setw(7) << stats.bytes_reserved / 1024
+				<< std::setw(8) << std::fixed << std::setprecision(2) << stats.index_load_factor << '\n';
+		}
+		std::cout.flush();
+	}
+
+	// One text line per shown container, re-created when a restart destroyed them
+	static std::vector<ECS::Entity> statsLines;
+	static const size_t STATS_OVERLAY_LINES = 10;
+
+	void updateStatsOverlay()
+	{
+		if (!in_debug_mode) {
+			for (ECS::Entity line : statsLines) {
+				if (ECS::registry<Text>().has(line))
+					ECS::ContainerInterface::destroy_entity(line);
+			}
+			statsLines.clear();
+			return;
+		}
+
+		const auto stats = sortedComponentStats();
+		statsLines.resize(STATS_OVERLAY_LINES, ECS::Entity::null());
+		for (size_t i = 0; i < STATS_OVERLAY_LINES; i++) {
+			std::stringstream content;
+			if (i < stats.size() && stats[i].count > 0) {
+				content << readableTypeName(stats[i].type_name) << ": " << stats[i].count
+					<< " (" << stats[i].bytes_used / 1024 << "/" << stats[i].bytes_reserved / 1024 << " KiB, +"
+					<< stats[i].inserts_last_frame << " -" << stats[i].removes_last_frame << ")";
+			}
+			if (!ECS::registry<Text>().has(statsLines[i]))
+				statsLines[i] = Text::create_text("", { 10.f, 770.f - 18.f * i }, 0.35f);
+			Text& text = ECS::registry<Text>().get(statsLines[i]);
+			if (text.content != content.str())
+				ECS::registry<Text>().patch(statsLines[i]).content = content.str();
+		}
+	}
 }
@@ -16,4 +16,12 @@ namespace DebugSystem {
 
 	// Removes all debugging graphics in ECS, called at every iteration of the game loop
 	void clearDebugComponents();
+
+	// Shows the memory use of the largest component containers on screen while in debug mode, called at every iteration of the game loop
+	void updateStatsOverlay();
+
+	// Memory and churn statistics of all component containers, see ECS::ContainerStats
+	std::string componentStatsJson();
+	void saveComponentStats(const std::string& path);
+	void printComponentStats();
 };
@@ -2,6 +2,8 @@
 #include "egg.hpp"
 #include "render.hpp"
 
+#include <algorithm>
+
 ECS::Entity Egg::createEgg(vec2 position)
 {
     // Reserve an entity
@@ -16,21 +18,107 @@ ECS::Entity Egg::createEgg(vec2 position)
         RenderSystem::createSprite(resource, textures_path("npc_egg.png"), "textured");
     }
     // Store a reference to the potentially re-used mesh object (the value is stored in the resource cache)
-    ECS::registry<ShadedMeshRef>.emplace(entity, resource);
+    ECS::registry<ShadedMeshRef>().emplace(entity, resource);
     // adding reference to eggAi
-    ECS::registry<EggAi>.emplace(entity);
+    ECS::registry<EggAi>().emplace(entity);
     
     // Initialize the position, scale and physics components.
     // The only relevant component is position, as the others will not be used.
-    auto& motion = ECS::registry<Motion>.emplace(entity);
+    auto& motion = ECS::registry<Motion>().emplace(entity);
     motion.angle = 0.f;
     motion.velocity = {0.f, 0.f};
     motion.position = position;
     motion.scale = vec2({0.5f, 0.5f}) * static_cast<vec2>(resource.texture.size);
     motion.direction = { 1.f, 1.f };
-    motion.shape = "circle";
+    motion.shape = Shape::egg;
+    // Eggs move by the velocity the AI gives them
+    auto& body = ECS::registry<RigidBody>().emplace(entity);
+    body.type = BodyType::Kinematic;
+    body.previous_position = position;
     
-    ECS::registry<Egg>.emplace(entity);
+    ECS::registry<Egg>().emplace(entity);
     return entity;
 }
 
+// Andrew's monotone chain, returns the hull counter-clockwise without repeating the first point
+static std::vector<vec2> convexHull(std::vector<vec2> points)
+{
+    std::sort(points.begin(), points.end(), [](vec2 a, vec2 b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.size() < 3)
+        return points;
+
+    auto cross = [](vec2 o, vec2 a, vec2 b) { return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x); };
+    std::vector<vec2> hull(2 * points.size());
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0)
+            k--;
+        hull[k++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = k + 1; i > 0; i--)
+    {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0)
+            k--;
+        hull[k++] = points[i - 1];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+static std::vector<vec2> computeEggHull()
+{
+    int width, height;
+    stbi_uc* data = stbi_load(textures_path("npc_egg.png").c_str(), &width, &height, NULL, 4);
+    std::vector<vec2> points;
+    if (data != NULL)
+    {
+        // The corners of every mostly opaque pixel, with the top row of the image at -0.5 like the sprite's texture coordinates
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                if (data[(y * width + x) * 4 + 3] < 128)
+                    continue;
+                for (int corner = 0; corner < 4; corner++)
+                {
+                    points.push_back({ (x + corner % 2) / float(width) - 0.5f, (y + corner / 2) / float(height) - 0.5f });
+                }
+            }
+        }
+        stbi_image_free(data);
+    }
+
+    std::vector<vec2> hull = convexHull(points);
+    if (hull.size() < 3)
+    {
+        // Fall back to an ellipse filling the sprite
+        hull.clear();
+        const int segments = 16;
+        for (int i = 0; i < segments; i++)
+        {
+            float angle = 2.f * PI * i / segments;
+            hull.push_back({ 0.5f * cos(angle), 0.5f * sin(angle) });
+        }
+    }
+    return hull;
+}
+
+const std::vector<vec2>& Egg::hull()
+{
+    static const std::vector<vec2> eggHull = computeEggHull();
+    return eggHull;
+}
+
+void ECS::Serializer<Egg>::write(ECS::SnapshotWriter& out, const Egg& egg)
+{
+    out.write(egg.gridLocation);
+}
+
+Egg ECS::Serializer<Egg>::read(ECS::SnapshotReader& in)
+{
+    Egg egg;
+    in.read(egg.gridLocation);
+    return egg;
+}
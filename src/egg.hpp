@@ -9,5 +9,16 @@ struct Egg
     // Create all the associated render resources and default transform.
     static ECS::Entity createEgg(vec2 position);
 
+    // Convex outline of the egg sprite in its local space, i.e., within [-0.5, 0.5] on both axes before scaling by Motion::scale.
+    // Built once from the alpha of npc_egg.png, or an ellipse if the texture can't be read.
+    static const std::vector<vec2>& hull();
+
+};
+
+template <> struct ECS::Serializer<Egg>
+{
+    static constexpr bool available = true;
+    static void write(ECS::SnapshotWriter& out, const Egg& egg);
+    static Egg read(ECS::SnapshotReader& in);
 };
 
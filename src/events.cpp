@@ -0,0 +1,21 @@
+// Header
+#include "events.hpp"
+
+unsigned int EventBus::next_event_type_id()
+{
+	static unsigned int next_id = 0;
+	return next_id++;
+}
+
+void EventBus::dispatch()
+{
+	// By index, handlers can publish events of types not seen before
+	for (size_t i = 0; i < dispatch_order.size(); i++)
+		queues[dispatch_order[i]]->dispatch();
+}
+
+void EventBus::clear()
+{
+	for (unsigned int id : dispatch_order)
+		queues[id]->clear();
+}
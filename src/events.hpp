@@ -0,0 +1,85 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Typed event queues. Systems publish events into one contiguous queue per event type, dispatch() then hands every
+// handler the whole queue of its type at once, so a handler is one loop over an array instead of a call per event.
+class EventBus
+{
+public:
+	template <typename Event>
+	using Handler = std::function<void(const std::vector<Event>& events)>;
+
+	template <typename Event>
+	void publish(const Event& event)
+	{
+		queue<Event>().events.push_back(event);
+	}
+
+	// Handlers of one event type run in the order they subscribed, they must not publish events of their own type
+	template <typename Event>
+	void subscribe(Handler<Event> handler)
+	{
+		queue<Event>().handlers.push_back(std::move(handler));
+	}
+
+	// Passes the queued events to their handlers and empties the queues. Event types are dispatched in the order
+	// they were first used, events published by a handler are dispatched in the same call if their type comes later.
+	void dispatch();
+
+	// Drops all queued events without handling them
+	void clear();
+
+private:
+	struct QueueInterface
+	{
+		virtual ~QueueInterface() = default;
+		virtual void dispatch() = 0;
+		virtual void clear() = 0;
+	};
+
+	template <typename Event>
+	struct Queue : QueueInterface
+	{
+		std::vector<Event> events;
+		std::vector<Handler<Event>> handlers;
+
+		void dispatch() override
+		{
+			if (events.empty())
+				return;
+			for (auto& handler : handlers)
+				handler(events);
+			events.clear();
+		}
+		void clear() override { events.clear(); }
+	};
+
+	static unsigned int next_event_type_id();
+
+	template <typename Event>
+	static unsigned int event_type_id()
+	{
+		static const unsigned int id = next_event_type_id();
+		return id;
+	}
+
+	template <typename Event>
+	Queue<Event>& queue()
+	{
+		const unsigned int id = event_type_id<Event>();
+		if (id >= queues.size())
+			queues.resize(id + 1);
+		if (!queues[id])
+		{
+			queues[id] = std::make_unique<Queue<Event>>();
+			dispatch_order.push_back(id);
+		}
+		return static_cast<Queue<Event>&>(*queues[id]);
+	}
+
+	std::vector<std::unique_ptr<QueueInterface>> queues; // indexed by event type id
+	std::vector<unsigned int> dispatch_order;
+};
@@ -21,15 +21,15 @@ ECS::Entity HelpTool::createHelpTool(vec2 position)
     }
 
     // Store a reference to the potentially re-used mesh object (the value is stored in the resource cache)
-    ECS::registry<ShadedMeshRef>.emplace(entity, resource);
+    ECS::registry<ShadedMeshRef>().emplace(entity, resource);
 
     // Initialize the position, scale and physics components.
     // The only relevant component is position, as the others will not be used.
-    auto& motion = ECS::registry<Motion>.emplace(entity);
+    auto& motion = ECS::registry<Motion>().emplace(entity);
     motion.position = position;
     motion.scale = vec2({ 0.90f, 0.75f }) * static_cast<vec2>(resource.texture.size);
 
-    ECS::registry<HelpTool>.emplace(entity);
+    ECS::registry<HelpTool>().emplace(entity);
 
     exit_help = Button::createButton({ motion.position.x*1.86, motion.position.y/3.5 }, { 0.41,0.41 }, ButtonEnum::ExitTool, "");
 
@@ -40,7 +40,7 @@ ECS::Entity HelpTool::createHelpTool(vec2 position)
 void HelpTool::handleHelpToolClicks(double mouse_x, double mouse_y)
 {
 	if (PhysicsSystem::is_entity_clicked(exit_help, mouse_x, mouse_y)) {
-        ECS::ContainerInterface::remove_all_components_of(exit_help);
+        ECS::ContainerInterface::destroy_entity(exit_help);
         WorldSystem::enable_help(false);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+// Header
+#include "jobs.hpp"
+
+#include <cassert>
+
+static thread_local unsigned int job_thread_index = 0;
+
+JobSystem& JobSystem::instance()
+{
+	// Meyer's singleton, the workers start on first use
+	static JobSystem jobs(std::max(1u, std::thread::hardware_concurrency()) - 1);
+	return jobs;
+}
+
+JobSystem::JobSystem(unsigned int worker_count)
+{
+	for (unsigned int i = 0; i <= worker_count; i++)
+		queues.push_back(std::make_unique<Queue>());
+	for (unsigned int i = 1; i <= worker_count; i++)
+		workers.emplace_back(&JobSystem::worker_loop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto& worker : workers)
+		worker.join();
+}
+
+unsigned int JobSystem::current_thread()
+{
+	return job_thread_index;
+}
+
+void JobSystem::submit(Job job, Counter& counter)
+{
+	counter.pending.fetch_add(1, std::memory_order_relaxed);
+	Queue& queue = *queues[current_thread() < queues.size() ? current_thread() : 0];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back({ std::move(job), &counter, &ECS::World::current() });
+	}
+	{
+		// Taking the lock orders the increment with a worker that is about to sleep
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		queued.fetch_add(1, std::memory_order_release);
+	}
+	wake.notify_one();
+}
+
+bool JobSystem::pop(unsigned int thread, Task& task)
+{
+	// Newest job of the own queue first, it is most likely still in cache
+	{
+		Queue& own = *queues[thread];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+	// Otherwise steal the oldest job of another queue, those tend to be the largest pieces of work left
+	for (unsigned int i = 1; i < queues.size(); i++)
+	{
+		Queue& victim = *queues[(thread + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+bool JobSystem::run_one()
+{
+	if (queued.load(std::memory_order_acquire) == 0)
+		return false;
+	Task task;
+	if (!pop(current_thread() < queues.size() ? current_thread() : 0, task))
+		return false;
+	queued.fetch_sub(1, std::memory_order_relaxed);
+	{
+		ECS::World::Scope scope(*task.world);
+		task.job();
+	}
+	task.counter->pending.fetch_sub(1, std::memory_order_release);
+	return true;
+}
+
+void JobSystem::wait(Counter& counter)
+{
+	while (!counter.done())
+	{
+		if (!run_one())
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::worker_loop(unsigned int thread)
+{
+	job_thread_index = thread;
+	while (true)
+	{
+		if (run_one())
+			continue;
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		wake.wait(lock, [&]() { return stopping || queued.load(std::memory_order_acquire) > 0; });
+		if (stopping)
+			return;
+	}
+}
+
+TaskGraph::Task TaskGraph::add(std::function<void()> fn, bool main_thread)
+{
+	nodes.push_back({ std::move(fn), main_thread, {}, 0 });
+	// Sized with the graph, such that running it only resets the counters
+	remaining.reset(new std::atomic<unsigned int>[nodes.size()]);
+	return static_cast<Task>(nodes.size() - 1);
+}
+
+void TaskGraph::precede(Task before, Task after)
+{
+	assert(before < nodes.size() && after < nodes.size());
+	nodes[before].successors.push_back(after);
+	nodes[after].predecessors++;
+}
+
+void TaskGraph::dispatch(JobSystem& jobs, Task task)
+{
+	if (nodes[task].main_thread)
+	{
+		std::lock_guard<std::mutex> lock(main_thread_mutex);
+		main_thread_ready.push_back(task);
+		return;
+	}
+	jobs.submit([this, &jobs, task]() {
+		nodes[task].fn();
+		finish(jobs, task);
+	}, counter);
+}
+
+void TaskGraph::finish(JobSystem& jobs, Task task)
+{
+	for (Task successor : nodes[task].successors)
+	{
+		if (remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			dispatch(jobs, successor);
+	}
+	unfinished.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void TaskGraph::run(JobSystem& jobs)
+{
+	for (Task task = 0; task < nodes.size(); task++)
+		remaining[task].store(nodes[task].predecessors, std::memory_order_relaxed);
+	unfinished.store(static_cast<unsigned int>(nodes.size()), std::memory_order_release);
+	for (Task task = 0; task < nodes.size(); task++)
+	{
+		if (nodes[task].predecessors == 0)
+			dispatch(jobs, task);
+	}
+
+	// The calling thread runs the main thread tasks and helps with the others until the graph is done
+	while (unfinished.load(std::memory_order_acquire) > 0)
+	{
+		Task task = 0;
+		bool has_main_thread_task = false;
+		{
+			std::lock_guard<std::mutex> lock(main_thread_mutex);
+			if (!main_thread_ready.empty())
+			{
+				task = main_thread_ready.front();
+				main_thread_ready.erase(main_thread_ready.begin());
+				has_main_thread_task = true;
+			}
+		}
+		if (has_main_thread_task)
+		{
+			nodes[task].fn();
+			finish(jobs, task);
+		}
+		else if (!jobs.run_one())
+			std::this_thread::yield();
+	}
+	// Jobs decrement the counter after finish(), do not return while one of them still touches this graph
+	jobs.wait(counter);
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "tiny_ecs.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A work-stealing thread pool. Every thread has its own job queue, takes the newest job of its own queue first
+// and steals the oldest job of another queue when its own is empty. Threads that wait for jobs run jobs meanwhile.
+// Jobs must not create or destroy entities or add or remove components, the ECS is only safe for concurrent access to distinct components.
+// A job runs in the ECS::World that was current on the thread that submitted it.
+class JobSystem
+{
+public:
+	using Job = std::function<void()>;
+
+	// Counts the unfinished jobs of one batch, wait() returns once it reaches zero
+	class Counter
+	{
+	public:
+		bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+	private:
+		friend class JobSystem;
+		std::atomic<unsigned int> pending{ 0 };
+	};
+
+	// The pool shared by all systems, one thread per core with the calling (main) thread counted as one of them
+	static JobSystem& instance();
+
+	explicit JobSystem(unsigned int worker_count);
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Number of threads that run jobs, including the thread that waits
+	unsigned int thread_count() const { return static_cast<unsigned int>(queues.size()); }
+	// 0 for threads outside the pool (e.g., the main thread), 1 to thread_count() - 1 for the workers
+	static unsigned int current_thread();
+
+	void submit(Job job, Counter& counter);
+	// Runs jobs until all jobs counted by counter finished
+	void wait(Counter& counter);
+	// Runs one queued job if there is any, for threads that wait on something else
+	bool run_one();
+
+	// Calls fn(begin, end) for consecutive index ranges of at most chunk_size covering [0, count), on all threads, and returns when all finished
+	template <typename Function>
+	void parallel_for(size_t count, size_t chunk_size, Function fn)
+	{
+		chunk_size = std::max<size_t>(chunk_size, 1);
+		if (count <= chunk_size || thread_count() == 1)
+		{
+			fn(size_t(0), count);
+			return;
+		}
+		Counter counter;
+		for (size_t begin = chunk_size; begin < count; begin += chunk_size)
+			submit([=, &fn]() { fn(begin, std::min(begin + chunk_size, count)); }, counter);
+		// The first chunk runs right here
+		fn(size_t(0), std::min(chunk_size, count));
+		wait(counter);
+	}
+
+	// Calls fn(entity, component) for every component of the container in chunks of chunk_size components.
+	// fn may modify the visited component and read others, but must not add or remove components.
+	template <typename Component, typename Function>
+	void parallel_for(ECS::ComponentContainer<Component>& container, size_t chunk_size, Function fn)
+	{
+		parallel_for(container.size(), chunk_size, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++)
+				fn(container.entities[i], container.components[i]);
+		});
+	}
+
+private:
+	struct Task
+	{
+		Job job;
+		Counter* counter;
+		ECS::World* world; // current when the job was submitted
+	};
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	void worker_loop(unsigned int thread);
+	bool pop(unsigned int thread, Task& task);
+
+	std::vector<std::unique_ptr<Queue>> queues; // queue 0 is shared by all threads outside the pool
+	std::vector<std::thread> workers;
+	std::atomic<unsigned int> queued{ 0 };
+	std::atomic<bool> stopping{ false };
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+};
+
+// Tasks with dependencies between them, run on a JobSystem. Tasks whose dependencies finished run in parallel.
+// The graph can be run any number of times, e.g., once per frame.
+class TaskGraph
+{
+public:
+	using Task = unsigned int;
+
+	// main_thread tasks only run on the thread that calls run(), e.g., for GLFW, OpenGL or audio calls
+	Task add(std::function<void()> fn, bool main_thread = false);
+	// after only starts once before finished
+	void precede(Task before, Task after);
+
+	void run(JobSystem& jobs);
+
+private:
+	struct Node
+	{
+		std::function<void()> fn;
+		bool main_thread = false;
+		std::vector<Task> successors;
+		unsigned int predecessors = 0;
+	};
+
+	// Starts the task, or queues it for the main thread
+	void dispatch(JobSystem& jobs, Task task);
+	void finish(JobSystem& jobs, Task task);
+
+	std::vector<Node> nodes;
+
+	// State of the current run, remaining has one counter per node
+	std::unique_ptr<std::atomic<unsigned int>[]> remaining;
+	std::atomic<unsigned int> unfinished{ 0 };
+	std::mutex main_thread_mutex;
+	std::vector<Task> main_thread_ready;
+	JobSystem::Counter counter;
+};
@@ -7,6 +7,7 @@
 #include "map_loader.hpp"
 #include "tile.hpp"
 #include "text.hpp"
+#include "utils.hpp"
 
 // stlib
 #include <filesystem>
@@ -40,7 +41,7 @@ bool is_tile(LevelEditor::EditorEntity entity) {
 
 // Do not let blobules be placed on block tiles or water tiles
 bool bad_blobule_placement(ECS::Entity entity) {
-	Tile tile_component = ECS::registry<Tile>.get(entity);
+	Tile tile_component = ECS::registry<Tile>().get(entity);
 	return (tile_component.terrain_type == TerrainType::Block || tile_component.terrain_type == TerrainType::Water);
 }
 
@@ -151,11 +152,11 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 	has_changes = true;
 
 	// Remove any text that is not the save button text
-	for (ECS::Entity text : ECS::registry<Text>.entities)
+	for (ECS::Entity text : ECS::registry<Text>().entities)
 	{
-		if (ECS::registry<Text>.get(text).content != "Save")
+		if (ECS::registry<Text>().get(text).content != "Save")
 		{
-			ECS::registry<Text>.remove(text);
+			ECS::registry<Text>().remove(text);
 		}
 	}
 
@@ -163,7 +164,7 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 	int x_coord = grid_coords.x;
 	int y_coord = grid_coords.y;
 	ECS::Entity selected_tile = grid[y_coord][x_coord];
-	Motion& selected_tile_motion = ECS::registry<Motion>.get(selected_tile);
+	Motion& selected_tile_motion = ECS::registry<Motion>().get(selected_tile);
 
 	// If the entity that's being placed is a tile, replace the selected tile
 	if (is_tile(entity))
@@ -173,7 +174,7 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		{
 			for (ECS::Entity blob : editor_blobule_list)
 			{
-				if (ECS::registry<Blobule>.get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>.get(blob).currentGrid[1] == y_coord)
+				if (ECS::registry<Blobule>().get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>().get(blob).currentGrid[1] == y_coord)
 				{
 					return;
 				}
@@ -183,10 +184,10 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		if (entity == EditorEntity::Teleport)
 			numTeleporters++;
 
-		ECS::registry<Tile>.remove(selected_tile);
+		ECS::registry<Tile>().remove(selected_tile);
 		ECS::Entity tile = Tile::createTile(selected_tile_motion.position, entity_to_terrain_type(entity));
 		grid[y_coord][x_coord] = tile;
-		auto& tile_component = ECS::registry<Tile>.get(tile);
+		auto& tile_component = ECS::registry<Tile>().get(tile);
 		tile_component.gridLocation = { y_coord, x_coord };
 	}
 	// If the entity that is being placed is a blob, move it appropriately
@@ -199,9 +200,9 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		// Check that we're not trying to take another blob's spot
 		for (ECS::Entity blob : editor_blobule_list)
 		{
-			if (ECS::registry<Blobule>.get(blob).color != "yellow")
+			if (ECS::registry<Blobule>().get(blob).color != "yellow")
 			{
-				if (ECS::registry<Blobule>.get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>.get(blob).currentGrid[1] == y_coord)
+				if (ECS::registry<Blobule>().get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>().get(blob).currentGrid[1] == y_coord)
 					return;
 			}
 		}
@@ -209,10 +210,10 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		// Find the right blob and move it
 		for (ECS::Entity blob : editor_blobule_list)
 		{
-			if (ECS::registry<Blobule>.get(blob).color == "yellow")
+			if (ECS::registry<Blobule>().get(blob).color == "yellow")
 			{
-				ECS::registry<Motion>.get(blob).position = selected_tile_motion.position;
-				ECS::registry<Blobule>.get(blob).currentGrid = { x_coord, y_coord };
+				Utils::placeBody(blob, selected_tile_motion.position);
+				ECS::registry<Blobule>().get(blob).currentGrid = { x_coord, y_coord };
 			}
 		}
 	}
@@ -225,9 +226,9 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		// Check that we're not trying to take another blob's spot
 		for (ECS::Entity blob : editor_blobule_list)
 		{
-			if (ECS::registry<Blobule>.get(blob).color != "green")
+			if (ECS::registry<Blobule>().get(blob).color != "green")
 			{
-				if (ECS::registry<Blobule>.get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>.get(blob).currentGrid[1] == y_coord)
+				if (ECS::registry<Blobule>().get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>().get(blob).currentGrid[1] == y_coord)
 					return;
 			}
 		}
@@ -235,10 +236,10 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		// Find the right blob and move it
 		for (ECS::Entity blob : editor_blobule_list)
 		{
-			if (ECS::registry<Blobule>.get(blob).color == "green")
+			if (ECS::registry<Blobule>().get(blob).color == "green")
 			{
-				ECS::registry<Motion>.get(blob).position = selected_tile_motion.position;
-				ECS::registry<Blobule>.get(blob).currentGrid = { x_coord, y_coord };
+				Utils::placeBody(blob, selected_tile_motion.position);
+				ECS::registry<Blobule>().get(blob).currentGrid = { x_coord, y_coord };
 			}
 		}
 	}
@@ -251,9 +252,9 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		// Check that we're not trying to take another blob's spot
 		for (ECS::Entity blob : editor_blobule_list)
 		{
-			if (ECS::registry<Blobule>.get(blob).color != "red")
+			if (ECS::registry<Blobule>().get(blob).color != "red")
 			{
-				if (ECS::registry<Blobule>.get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>.get(blob).currentGrid[1] == y_coord)
+				if (ECS::registry<Blobule>().get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>().get(blob).currentGrid[1] == y_coord)
 					return;
 			}
 		}
@@ -261,10 +262,10 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		// Find the right blob and move it
 		for (ECS::Entity blob : editor_blobule_list)
 		{
-			if (ECS::registry<Blobule>.get(blob).color == "red")
+			if (ECS::registry<Blobule>().get(blob).color == "red")
 			{
-				ECS::registry<Motion>.get(blob).position = selected_tile_motion.position;
-				ECS::registry<Blobule>.get(blob).currentGrid = { x_coord, y_coord };
+				Utils::placeBody(blob, selected_tile_motion.position);
+				ECS::registry<Blobule>().get(blob).currentGrid = { x_coord, y_coord };
 			}
 		}
 	}
@@ -277,9 +278,9 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		// Check that we're not trying to take another blob's spot
 		for (ECS::Entity blob : editor_blobule_list)
 		{
-			if (ECS::registry<Blobule>.get(blob).color != "blue")
+			if (ECS::registry<Blobule>().get(blob).color != "blue")
 			{
-				if (ECS::registry<Blobule>.get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>.get(blob).currentGrid[1] == y_coord)
+				if (ECS::registry<Blobule>().get(blob).currentGrid[0] == x_coord && ECS::registry<Blobule>().get(blob).currentGrid[1] == y_coord)
 					return;
 			}
 		}
@@ -287,10 +288,10 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		// Find the right blob and move it
 		for (ECS::Entity blob : editor_blobule_list)
 		{
-			if (ECS::registry<Blobule>.get(blob).color == "blue")
+			if (ECS::registry<Blobule>().get(blob).color == "blue")
 			{
-				ECS::registry<Motion>.get(blob).position = selected_tile_motion.position;
-				ECS::registry<Blobule>.get(blob).currentGrid = { x_coord, y_coord };
+				Utils::placeBody(blob, selected_tile_motion.position);
+				ECS::registry<Blobule>().get(blob).currentGrid = { x_coord, y_coord };
 			}
 		}
 	}
@@ -299,7 +300,7 @@ void LevelEditor::place_entity(std::vector<std::vector<ECS::Entity>>& grid, Edit
 		// Only allow one egg
 		if (editor_egg_list.size() < 1) {
 			ECS::Entity egg = Egg::createEgg(selected_tile_motion.position);
-			ECS::registry<Egg>.get(egg).gridLocation = { x_coord, y_coord };
+			ECS::registry<Egg>().get(egg).gridLocation = { x_coord, y_coord };
 			editor_egg_list.push_back(egg);
 		}
 	}
@@ -343,7 +344,7 @@ void LevelEditor::save_map(std::vector<std::vector<ECS::Entity>> grid) {
 	{
 		for (int j = 0; j < numCols; j++)
 		{
-			Tile current_tile = ECS::registry<Tile>.get(grid[i][j]);
+			Tile current_tile = ECS::registry<Tile>().get(grid[i][j]);
 			gridFile << tile_to_CSV(current_tile) + (j < numCols - 1 ? "," : "\n");
 		}
 	}
@@ -365,8 +366,8 @@ void LevelEditor::save_map(std::vector<std::vector<ECS::Entity>> grid) {
 	std::vector<std::vector<int>> entitiesPosition;
 	std::vector<std::vector<float>> entitiesScale;
 	for (auto entity : editor_blobule_list) {
-		auto& blob = ECS::registry<Blobule>.get(entity);
-		auto& motion = ECS::registry<Motion>.get(entity);
+		auto& blob = ECS::registry<Blobule>().get(entity);
+		auto& motion = ECS::registry<Motion>().get(entity);
 		entitiesPosition.push_back(blob.currentGrid);
 		entitiesScale.push_back({ motion.scale.x, motion.scale.y });
 	}
@@ -376,7 +377,7 @@ void LevelEditor::save_map(std::vector<std::vector<ECS::Entity>> grid) {
 	// SAVE EGG INFO
 	std::vector<std::vector<int>> eggsPosition;
 	for (ECS::Entity entity : editor_egg_list) {
-		auto& egg = ECS::registry<Egg>.get(entity);
+		auto& egg = ECS::registry<Egg>().get(entity);
 		eggsPosition.push_back(egg.gridLocation);
 	}
 	mapInfo["eggPositions"] = eggsPosition;
@@ -5,6 +5,7 @@
 // stlib
 #include <chrono>
 #include <iostream>
+#include <cmath>
 
 // internal
 #include "common.hpp"
@@ -15,12 +16,20 @@
 #include "collisions.hpp"
 #include "ai.hpp"
 #include "debug.hpp"
+#include "scheduler.hpp"
 #include <powerup.hpp>
+#include <egg.hpp>
+#include "tile.hpp"
+
+// Declared only, text.hpp's Font clashes with the X11 Font that gl3w's implementation pulls in
+struct Text;
 
 using Clock = std::chrono::high_resolution_clock;
 
 const ivec2 window_size_in_px = {1000, 800};
 const vec2 window_size_in_game_units = { 1000, 800 };
+// After a stall (e.g., dragging the window) the simulation skips ahead rather than trying to catch up with many steps
+const int max_steps_per_frame = 8;
 // Note, here the window will show a width x height part of the game world, measured in px. 
 // You could also define a window to show 1.5 x 1 part of your game world, where the aspect ratio depends on your window size.
 
@@ -32,20 +41,40 @@ struct Description {
 // Entry point
 int main()
 {
-	// Initialize the main systems
-	WorldSystem world(window_size_in_px);
+	// Initialize the main systems, all of them run on the entities and components of the game's world
+	ECS::World& game = ECS::World::main();
+	WorldSystem world(window_size_in_px, game);
 	RenderSystem renderer(*world.window);
-	PhysicsSystem physics;
-	CollisionSystem collision;
-	AISystem ai;
-	PowerupSystem powerup;
+	PhysicsSystem physics(game);
+	CollisionSystem collision(game);
+	AISystem ai(game);
+	PowerupSystem powerup(game);
 
 	// Set all states to default
 	world.restart();
 	auto t = Clock::now();
 	collision.initialize_collisions();
 
-	// Variable timestep loop
+	// The systems in their sequential order, with the components they touch such that independent ones can overlap.
+	// Structural changes go through each system's CommandBuffer, the scheduler applies them once all systems finished.
+	Scheduler scheduler;
+	scheduler.add("ai", Scheduler::Access().reads<Blobule>().writes<Motion, EggAi>(),
+		[&](ECS::CommandBuffer&) { ai.step(simulation_step_ms, window_size_in_game_units); });
+	scheduler.add("turn", Scheduler::Access().reads<Tile, Egg>().writes<Motion, Blobule, RigidBody, Text>(),
+		[&](ECS::CommandBuffer&) { world.update_turn(window_size_in_game_units); });
+	// Only reads what the bodies are, so the score and window title are updated while physics runs
+	scheduler.add("world", Scheduler::Access().reads<Blobule, Egg, YellowSplat, GreenSplat, RedSplat, BlueSplat>().writes<Text>().on_main_thread(),
+		[&](ECS::CommandBuffer& commands) { world.step(simulation_step_ms, window_size_in_game_units, commands); });
+	scheduler.add("physics", Scheduler::Access().reads<Blobule, Egg, Tile, Terrain>().writes<Motion, RigidBody>().writes_resources<ContactBuffer, TerrainSample>(),
+		[&](ECS::CommandBuffer&) { physics.step(simulation_step_ms, window_size_in_game_units); });
+	scheduler.add("powerup", Scheduler::Access().writes<PowerupSystem::Powerup, Motion>(),
+		[&](ECS::CommandBuffer& commands) { powerup.handle_powerups(commands); });
+	scheduler.add("collision", Scheduler::Access().reads<Tile, Terrain, YellowSplat, GreenSplat, RedSplat, BlueSplat>().writes<Motion, RigidBody, Blobule, Egg>()
+		.reads_resources<ContactBuffer, TerrainSample>().on_main_thread(),
+		[&](ECS::CommandBuffer& commands) { collision.handle_collisions(physics.contacts, physics.terrain, commands); });
+
+	// Fixed timestep loop, rendering interpolates the bodies between the last two simulation steps
+	float accumulator_ms = 0.f;
 	while (!world.is_over())
 	{
 		// Processes system messages, if this wasn't present the window would become unresponsive
@@ -55,17 +84,30 @@ int main()
 		auto now = Clock::now();
 		float elapsed_ms = static_cast<float>((std::chrono::duration_cast<std::chrono::microseconds>(now - t)).count()) / 1000.f;
 		t = now;
+		ECS::advance_frame();
 
+		float interpolation = 1.f;
 		if (world.gameState != GameState::LevelEditor)
 		{
-			ai.step(elapsed_ms, window_size_in_game_units);
-			world.step(elapsed_ms, window_size_in_game_units);
-			physics.step(elapsed_ms, window_size_in_game_units);
-			powerup.handle_powerups();
-			collision.handle_collisions();
+			accumulator_ms += elapsed_ms;
+			int steps = 0;
+			while (accumulator_ms >= simulation_step_ms && steps < max_steps_per_frame)
+			{
+				world.restart_if_requested();
+				scheduler.run();
+				accumulator_ms -= simulation_step_ms;
+				steps++;
+			}
+			if (steps == max_steps_per_frame)
+				accumulator_ms = std::fmod(accumulator_ms, simulation_step_ms);
+			interpolation = accumulator_ms / simulation_step_ms;
 		}
-		renderer.draw(elapsed_ms, window_size_in_game_units);
+		DebugSystem::updateStatsOverlay();
+		renderer.draw(elapsed_ms, window_size_in_game_units, interpolation);
 	}
 
+	if (DebugSystem::in_debug_mode)
+		scheduler.save_trace("schedule_trace.json");
+
 	return EXIT_SUCCESS;
 }
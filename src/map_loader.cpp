@@ -35,7 +35,7 @@ void createTileIsland(std::vector<std::vector<std::string>> csvGrid) {
 		auto row = csvGrid[i];
 		std::vector<ECS::Entity> newRow;
 		for (int j = 0; j < row.size(); j++) {
-			ECS::Entity tile;
+			ECS::Entity tile = ECS::Entity::null();
 			std::string value = row[j];
 			value.erase(std::remove(value.begin(), value.end(), '\r'), value.end());
 
@@ -78,7 +78,7 @@ void createTileIsland(std::vector<std::vector<std::string>> csvGrid) {
 			else { // default case: value == "Water"
 				tile = Tile::createTile({ xPos, yPos }, Water);
 			}
-			auto& tileComponent = ECS::registry<Tile>.get(tile);
+			auto& tileComponent = ECS::registry<Tile>().get(tile);
 			tileComponent.gridLocation = { j, i };
 			newRow.push_back(tile);
 		}
@@ -90,8 +90,8 @@ void createBlobules(std::vector<std::vector<int>> blobulePositions) {
 	blobuleList.clear();
 	int count = 0;
 	for (auto position : blobulePositions) {
-		auto& motion = ECS::registry<Motion>.get(tileIsland[position[1]][position[0]]);
-		ECS::Entity blob;
+		auto& motion = ECS::registry<Motion>().get(tileIsland[position[1]][position[0]]);
+		ECS::Entity blob = ECS::Entity::null();
 		switch (count) {
 		case 0:
 			blob = Blobule::createBlobule(motion.position, blobuleCol::Yellow, "yellow");
@@ -106,7 +106,7 @@ void createBlobules(std::vector<std::vector<int>> blobulePositions) {
 			blob = Blobule::createBlobule(motion.position, blobuleCol::Blue, "blue");
 			break;
 		}
-		ECS::registry<Blobule>.get(blob).currentGrid = position;
+		ECS::registry<Blobule>().get(blob).currentGrid = position;
 		blobuleList.push_back(blob);
 		count++;
 	}
@@ -114,7 +114,7 @@ void createBlobules(std::vector<std::vector<int>> blobulePositions) {
 
 void createEggs(std::vector<std::vector<int>> eggPositions) {
 	for (auto position : eggPositions) {
-		auto& motion = ECS::registry<Motion>.get(tileIsland[position[1]][position[0]]);
+		auto& motion = ECS::registry<Motion>().get(tileIsland[position[1]][position[0]]);
 		Egg::createEgg(motion.position);
 	}
 }
@@ -122,8 +122,8 @@ void createEggs(std::vector<std::vector<int>> eggPositions) {
 void createWaterBorder(vec2 windowSize) {
 	float waterBorderWidth = 700.f;
 
-	vec2 topLeft = ECS::registry<Motion>.get(tileIsland[0][0]).position;
-	vec2 bottomRight = ECS::registry<Motion>.get(tileIsland[heightNum - 1][widthNum - 1]).position;
+	vec2 topLeft = ECS::registry<Motion>().get(tileIsland[0][0]).position;
+	vec2 bottomRight = ECS::registry<Motion>().get(tileIsland[heightNum - 1][widthNum - 1]).position;
 
 	float top = topLeft.y - tileSize;
 	float bot = bottomRight.y + tileSize;
@@ -165,7 +165,7 @@ void createWaterBorder(vec2 windowSize) {
 }
 
 void centerIsland(vec2 windowSize) {
-	vec2 offset = vec2{ windowSize.x / 2, windowSize.y / 2 } - ECS::registry<Motion>.get(tileIsland[heightNum / 2][widthNum / 2]).position;
+	vec2 offset = vec2{ windowSize.x / 2, windowSize.y / 2 } - ECS::registry<Motion>().get(tileIsland[heightNum / 2][widthNum / 2]).position;
 	Utils::moveCamera(offset.x, offset.y);
 }
 
@@ -194,7 +194,7 @@ void setBlobuleScales(std::vector<std::vector<float>> blobuleScales) {
 	for (int i = 0; i < blobuleScales.size(); i++) {
 		auto entity = blobuleList[i];
 		auto scale = blobuleScales[i];
-		auto& motion = ECS::registry<Motion>.get(entity);
+		auto& motion = ECS::registry<Motion>().get(entity);
 		motion.scale = { scale[0], scale[1] };
 	}
 }
@@ -265,8 +265,8 @@ void MapLoader::saveMap(int currentPlayer, int currentTurn) {
 	std::vector<std::vector<int>> entitiesPosition;
 	std::vector<std::vector<float>> entitiesScale;
 	for (auto entity : blobuleList) {
-		auto& blob = ECS::registry<Blobule>.get(entity);
-		auto& motion = ECS::registry<Motion>.get(entity);
+		auto& blob = ECS::registry<Blobule>().get(entity);
+		auto& motion = ECS::registry<Motion>().get(entity);
 		entitiesPosition.push_back(blob.currentGrid);
 		entitiesScale.push_back({ motion.scale.x, motion.scale.y });
 	}
@@ -275,8 +275,8 @@ void MapLoader::saveMap(int currentPlayer, int currentTurn) {
 
 	// SAVE EGG INFO
 	std::vector<std::vector<int>> eggsPosition;
-	for (ECS::Entity entity : ECS::registry<Egg>.entities) {
-		auto& egg = ECS::registry<Egg>.get(entity);
+	for (ECS::Entity entity : ECS::registry<Egg>().entities) {
+		auto& egg = ECS::registry<Egg>().get(entity);
 		eggsPosition.push_back(egg.gridLocation);
 	}
 	mapInfo["eggPositions"] = eggsPosition;
@@ -290,18 +290,18 @@ void MapLoader::saveMap(int currentPlayer, int currentTurn) {
 	for (int i = 0; i < tileIsland.size(); i++) {
 		auto row = tileIsland[i];
 		for (int j = 0; j < row.size(); j++) {
-			auto& tile = ECS::registry<Tile>.get(tileIsland[i][j]);
+			auto& tile = ECS::registry<Tile>().get(tileIsland[i][j]);
 			std::vector<int> currentGrid = { j, i };
-			if (ECS::registry<YellowSplat>.has(tile.splatEntity)) {
+			if (ECS::registry<YellowSplat>().has(tile.splatEntity)) {
 				yellowSplats.push_back(currentGrid);
 			}
-			else if (ECS::registry<GreenSplat>.has(tile.splatEntity)) {
+			else if (ECS::registry<GreenSplat>().has(tile.splatEntity)) {
 				greenSplats.push_back(currentGrid);
 			}
-			else if (ECS::registry<RedSplat>.has(tile.splatEntity)) {
+			else if (ECS::registry<RedSplat>().has(tile.splatEntity)) {
 				redSplats.push_back(currentGrid);
 			}
-			else if (ECS::registry<BlueSplat>.has(tile.splatEntity)) {
+			else if (ECS::registry<BlueSplat>().has(tile.splatEntity)) {
 				blueSplats.push_back(currentGrid);
 			}
 		}
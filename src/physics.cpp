@@ -4,9 +4,26 @@
 #include "debug.hpp"
 #include "blobule.hpp"
 #include "utils.hpp"
+#include "jobs.hpp"
+#include "tile.hpp"
 #include <iostream>
 #include <egg.hpp>
-#include <set>
+#include <limits>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <cmath>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PHYSICS_SSE2
+#endif
+
+// Dynamic bodies slower than this come to rest
+const float terminalVelocity = 20.f;
+// Awake bodies per parallel_for job
+const size_t BODY_CHUNK_SIZE = 256;
 
 // Returns the local bounding coordinates scaled by the current size of the entity
 vec2 get_bounding_box(const Motion& motion)
@@ -17,10 +34,10 @@ vec2 get_bounding_box(const Motion& motion)
 
 bool PhysicsSystem::is_entity_clicked(ECS::Entity e, float mouse_press_x, float mouse_press_y){
 
-	auto left_boundary = ECS::registry<Motion>.get(e).position.x - (ECS::registry<Motion>.get(e).scale.x / 2);
-	auto right_boundary = ECS::registry<Motion>.get(e).position.x + (ECS::registry<Motion>.get(e).scale.x / 2);
-	auto top_boundary = ECS::registry<Motion>.get(e).position.y - (ECS::registry<Motion>.get(e).scale.y / 2);
-	auto bottom_boundary = ECS::registry<Motion>.get(e).position.y + (ECS::registry<Motion>.get(e).scale.y / 2);
+	auto left_boundary = ECS::registry<Motion>().get(e).position.x - (ECS::registry<Motion>().get(e).scale.x / 2);
+	auto right_boundary = ECS::registry<Motion>().get(e).position.x + (ECS::registry<Motion>().get(e).scale.x / 2);
+	auto top_boundary = ECS::registry<Motion>().get(e).position.y - (ECS::registry<Motion>().get(e).scale.y / 2);
+	auto bottom_boundary = ECS::registry<Motion>().get(e).position.y + (ECS::registry<Motion>().get(e).scale.y / 2);
 
 	return mouse_press_x >= left_boundary && mouse_press_x <= right_boundary && mouse_press_y >= top_boundary && mouse_press_y <= bottom_boundary;
 }
@@ -64,138 +81,679 @@ Direction box_circle_collides(const Motion& box, const Motion& circle)
 		return Direction::unknown;
 }
 
-// circle circle collision check
-bool circle_circle_collides(const Motion& motion1, const Motion& motion2)
+// Consecutive points, e.g., part of a scratch buffer or a fixed-size array
+struct Points
+{
+	const vec2* data;
+	size_t size;
+	const vec2* begin() const { return data; }
+	const vec2* end() const { return data + size; }
+	const vec2& operator[](size_t i) const { return data[i]; }
+};
+
+// What the narrowphase knows about a shape. Eggs come with their outline in world space, transformed once per step.
+struct Collider
+{
+	const Motion& motion;
+	float radius; // of a circle around motion.position that contains the whole shape
+	Points outline; // eggs only
+};
+
+// Narrowphase test per pair of shapes, selected at compile time. collides(a, b, direction, penetration) tells whether a touches b,
+// if b is a box, which of its sides and, for eggs, how deep a is inside b. Pairs without a specialization never collide.
+template <Shape A, Shape B>
+struct Narrowphase
+{
+	static bool collides(const Collider&, const Collider&, Direction& direction, Penetration&)
+	{
+		direction = Direction::unknown;
+		return false;
+	}
+};
+
+template <>
+struct Narrowphase<Shape::circle, Shape::square>
+{
+	static bool collides(const Collider& circle, const Collider& box, Direction& direction, Penetration&)
+	{
+		direction = box_circle_collides(box.motion, circle.motion);
+		return direction != Direction::unknown;
+	}
+};
+
+template <>
+struct Narrowphase<Shape::square, Shape::circle>
+{
+	static bool collides(const Collider& box, const Collider& circle, Direction& direction, Penetration& penetration)
+	{
+		return Narrowphase<Shape::circle, Shape::square>::collides(circle, box, direction, penetration);
+	}
+};
+
+template <>
+struct Narrowphase<Shape::circle, Shape::circle>
 {
-	vec2 motion1_center = motion1.position;
-	vec2 motion2_center = motion2.position;
-	vec2 difference_between_centers = motion1_center - motion2_center;
-	float distance_between_centers = std::sqrt(dot(difference_between_centers, difference_between_centers));
-	float motion1_radius = motion1.scale.x / 2.f;
-	float motion2_radius = motion2.scale.x / 2.f;
-	return distance_between_centers < motion1_radius + motion2_radius;
+	static bool collides(const Collider& collider1, const Collider& collider2, Direction& direction, Penetration&)
+	{
+		direction = Direction::unknown;
+		vec2 difference_between_centers = collider1.motion.position - collider2.motion.position;
+		float distance_between_centers = std::sqrt(dot(difference_between_centers, difference_between_centers));
+		return distance_between_centers < collider1.motion.scale.x / 2.f + collider2.motion.scale.x / 2.f;
+	}
+};
+
+// Appends the outline of an egg in world space, transformed like its sprite
+void append_egg_outline(const Motion& egg, std::vector<vec2>& outline)
+{
+	const float c = cos(egg.angle);
+	const float s = sin(egg.angle);
+	for (vec2 point : Egg::hull())
+	{
+		vec2 scaled = point * egg.scale;
+		outline.push_back(egg.position + vec2(c * scaled.x - s * scaled.y, s * scaled.x + c * scaled.y));
+	}
 }
 
-void PhysicsSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
+// Radius of a circle around the shape's position that contains all of it, eggs use their outline
+float bounding_radius(const Motion& motion, Points outline)
 {
-	// Move entities based on how much time has passed, this is to (partially) avoid
-	// having entities move at different speed based on the machine.
+	switch (motion.shape)
+	{
+	case Shape::circle:
+		return motion.scale.x / 2.f;
+	case Shape::egg:
+	{
+		float radius = 0.f;
+		for (vec2 point : outline)
+			radius = std::max(radius, length(point - motion.position));
+		return radius;
+	}
+	default:
+		return length(motion.scale) / 2.f;
+	}
+}
 
-	for (auto& motion : ECS::registry<Motion>.components)
+void project(Points points, vec2 axis, float& low, float& high)
+{
+	low = std::numeric_limits<float>::max();
+	high = std::numeric_limits<float>::lowest();
+	for (vec2 point : points)
 	{
-		float step_seconds = 1.0f * (elapsed_ms / 1000.f);
-		motion.position = motion.position + (step_seconds * motion.velocity);
+		low = std::min(low, dot(point, axis));
+		high = std::max(high, dot(point, axis));
 	}
+}
 
-	(void)elapsed_ms; // placeholder to silence unused warning until implemented
-	(void)window_size_in_game_units;
+// Separating axis test between a convex polygon and either another convex point set or, with radius > 0, a circle around its only point.
+// Tests the polygon's edge normals plus extra_axes. On overlap, axis is the unit axis of least penetration, pointing either way,
+// and depth how far the shapes overlap along it.
+bool separating_axis_overlap(Points polygon, Points other, float radius, Points extra_axes, vec2& axis, float& depth)
+{
+	float least_overlap = std::numeric_limits<float>::max();
+	auto overlaps_on = [&](vec2 candidate) {
+		if (dot(candidate, candidate) == 0.f)
+			return true;
+		candidate = normalize(candidate);
+		float low1, high1, low2, high2;
+		project(polygon, candidate, low1, high1);
+		project(other, candidate, low2, high2);
+		low2 -= radius;
+		high2 += radius;
+		const float overlap = std::min(high1, high2) - std::max(low1, low2);
+		if (overlap <= 0.f)
+			return false;
+		if (overlap < least_overlap)
+		{
+			least_overlap = overlap;
+			axis = candidate;
+		}
+		return true;
+	};
+	for (size_t i = 0; i < polygon.size; i++)
+	{
+		vec2 edge = polygon[(i + 1) % polygon.size] - polygon[i];
+		if (!overlaps_on({ -edge.y, edge.x }))
+			return false;
+	}
+	for (vec2 extra : extra_axes)
+	{
+		if (!overlaps_on(extra))
+			return false;
+	}
+	depth = least_overlap;
+	return true;
+}
 
-	// Visualization for debugging the position and scale of objects
-	if (DebugSystem::in_debug_mode)
+template <>
+struct Narrowphase<Shape::egg, Shape::square>
+{
+	static bool collides(const Collider& egg, const Collider& box, Direction& direction, Penetration& penetration)
 	{
-		/*for (auto& motion : ECS::registry<Motion>.components)
+		direction = Direction::unknown;
+		// Cheap bounding circle check first, most tiles near the egg don't touch it
+		const vec2 position = egg.motion.position;
+		const vec2 half = abs(box.motion.scale) / 2.f;
+		const vec2 closest = glm::clamp(position, box.motion.position - half, box.motion.position + half);
+		if (dot(position - closest, position - closest) >= egg.radius * egg.radius)
+			return false;
+
+		const std::array<vec2, 4> corners = { box.motion.position - half, box.motion.position + vec2(half.x, -half.y),
+			box.motion.position + half, box.motion.position + vec2(-half.x, half.y) };
+		const std::array<vec2, 2> box_axes = { vec2(1.f, 0.f), vec2(0.f, 1.f) };
+		vec2 axis;
+		float depth;
+		if (!separating_axis_overlap(egg.outline, { corners.data(), corners.size() }, 0.f, { box_axes.data(), box_axes.size() }, axis, depth))
+			return false;
+		// Out of the box, away from its center
+		penetration = { dot(axis, position - box.motion.position) < 0.f ? -axis : axis, depth };
+		// The box side the egg pushes into least deeply
+		if (abs(axis.x) >= abs(axis.y))
+			direction = position.x < box.motion.position.x ? Direction::Left : Direction::Right;
+		else
+			direction = position.y < box.motion.position.y ? Direction::Top : Direction::Bottom;
+		return true;
+	}
+};
+
+template <>
+struct Narrowphase<Shape::square, Shape::egg>
+{
+	static bool collides(const Collider& box, const Collider& egg, Direction& direction, Penetration& penetration)
+	{
+		if (!Narrowphase<Shape::egg, Shape::square>::collides(egg, box, direction, penetration))
+			return false;
+		penetration.normal = -penetration.normal;
+		return true;
+	}
+};
+
+template <>
+struct Narrowphase<Shape::circle, Shape::egg>
+{
+	static bool collides(const Collider& circle, const Collider& egg, Direction& direction, Penetration& penetration)
+	{
+		direction = Direction::unknown;
+		const vec2 center = circle.motion.position;
+		const float reach = circle.radius + egg.radius;
+		if (dot(center - egg.motion.position, center - egg.motion.position) >= reach * reach)
+			return false;
+
+		// Besides the edge normals, the axis towards the outline point closest to the circle separates them if anything does
+		vec2 closest = egg.outline[0];
+		for (vec2 point : egg.outline)
 		{
-			DebugSystem::createBox(motion.position, motion.scale);
-		}*/
+			if (dot(point - center, point - center) < dot(closest - center, closest - center))
+				closest = point;
+		}
+		const vec2 closest_axis = closest - center;
+		vec2 axis;
+		float depth;
+		if (!separating_axis_overlap(egg.outline, { &center, 1 }, circle.radius, { &closest_axis, 1 }, axis, depth))
+			return false;
+		// The circle out of the egg, away from its center
+		penetration = { dot(axis, center - egg.motion.position) < 0.f ? -axis : axis, depth };
+		return true;
+	}
+};
+
+template <>
+struct Narrowphase<Shape::egg, Shape::circle>
+{
+	static bool collides(const Collider& egg, const Collider& circle, Direction& direction, Penetration& penetration)
+	{
+		if (!Narrowphase<Shape::circle, Shape::egg>::collides(circle, egg, direction, penetration))
+			return false;
+		penetration.normal = -penetration.normal;
+		return true;
 	}
+};
+
+using NarrowphaseFunction = bool (*)(const Collider&, const Collider&, Direction&, Penetration&);
 
-	// Go through the list of Blobules rather Motion
-	// For each blobule check what its colliding with using the collision detection functions above for each Motion
-	// We need nested for loop, inner loop goes through all of the motion, double check that the inner loop doesn't go through the blobule it's currently on (entity.id)
-	// 
+template <size_t... Pairs>
+constexpr std::array<NarrowphaseFunction, sizeof...(Pairs)> make_narrowphase_table(std::index_sequence<Pairs...>)
+{
+	return { { &Narrowphase<static_cast<Shape>(Pairs / SHAPE_COUNT), static_cast<Shape>(Pairs % SHAPE_COUNT)>::collides... } };
+}
+
+// Indexed by shape of a * SHAPE_COUNT + shape of b, adding a Shape adds its row and column here
+constexpr auto narrowphase_table = make_narrowphase_table(std::make_index_sequence<SHAPE_COUNT * SHAPE_COUNT>());
 
-	std::set<int> detectedBlobs = {};
+bool shapes_collide(const Collider& a, const Collider& b, Direction& direction, Penetration& penetration)
+{
+	assert(a.motion.shape != Shape::egg || a.outline.size > 0);
+	assert(b.motion.shape != Shape::egg || b.outline.size > 0);
+	return narrowphase_table[static_cast<int>(a.motion.shape) * SHAPE_COUNT + static_cast<int>(b.motion.shape)](a, b, direction, penetration);
+}
 
-	// Check for collisions between all moving entities
-	auto& blobule_container = ECS::registry<Blobule>;
-	auto& motion_container = ECS::registry<Motion>;
-	// for (auto [i, motion_i] : enumerate(motion_container.components)) // in c++ 17 we will be able to do this instead of the next three lines
-	for (unsigned int i = 0; i < blobule_container.components.size(); i++)
+void TileGrid::update()
+{
+	auto& tiles = ECS::registry<Tile>();
+	if (tiles.structure_version() == built_version)
+		return;
+	built_version = tiles.structure_version();
+	cell_tiles.clear();
+	cell_start.clear();
+	anchor = ECS::Entity::null();
+
+	// Bounds of the tile centers
+	auto& motion_container = ECS::registry<Motion>();
+	vec2 lower = vec2(std::numeric_limits<float>::max());
+	vec2 upper = vec2(std::numeric_limits<float>::lowest());
+	max_half_extent = 0.f;
+	for (ECS::Entity tile : tiles.entities)
 	{
-		ECS::Entity blob_entity_i = blobule_container.entities[i];
-		Motion& blob_motion_i = ECS::registry<Motion>.get(blob_entity_i);
+		if (!motion_container.has(tile))
+			continue;
+		const Motion& motion = motion_container.get(tile);
+		lower = glm::min(lower, motion.position);
+		upper = glm::max(upper, motion.position);
+		max_half_extent = std::max(max_half_extent, std::max(abs(motion.scale.x), abs(motion.scale.y)) / 2.f);
+		anchor = tile;
+	}
+	if (!ECS::valid(anchor))
+		return;
+	anchor_position = motion_container.get(anchor).position;
+	origin = lower;
+	dims = ivec2(glm::floor((upper - lower) / tileSize + 0.5f)) + 1;
 
-		for (unsigned int j = 0; j < motion_container.components.size(); j++)
+	// Counting sort of the tiles by cell
+	cell_start.assign(static_cast<size_t>(dims.x) * dims.y + 1, 0);
+	for (ECS::Entity tile : tiles.entities)
+	{
+		if (motion_container.has(tile))
+		{
+			ivec2 cell = cell_of(motion_container.get(tile).position);
+			cell_start[cell.y * dims.x + cell.x + 1]++;
+		}
+	}
+	for (size_t cell = 1; cell < cell_start.size(); cell++)
+		cell_start[cell] += cell_start[cell - 1];
+	cell_tiles.resize(cell_start.back());
+	std::vector<unsigned int> next(cell_start.begin(), cell_start.end() - 1);
+	for (ECS::Entity tile : tiles.entities)
+	{
+		if (motion_container.has(tile))
 		{
-			Motion& motion_j = motion_container.components[j];
-			ECS::Entity entity_j = motion_container.entities[j];
+			ivec2 cell = cell_of(motion_container.get(tile).position);
+			cell_tiles[next[cell.y * dims.x + cell.x]++] = tile;
+		}
+	}
+}
 
-			if (entity_j.id == blob_entity_i.id) {
-				continue;
-			}
+ECS::Entity TileGrid::tile_at(vec2 point) const
+{
+	if (cell_tiles.empty())
+		return ECS::Entity::null();
+	const vec2 offset = ECS::registry<Motion>().get(anchor).position - anchor_position;
+	const ivec2 cell = ivec2(glm::floor((point - offset - origin) / tileSize + 0.5f));
+	if (cell.x < 0 || cell.y < 0 || cell.x >= dims.x || cell.y >= dims.y)
+		return ECS::Entity::null();
+	const unsigned int index = static_cast<unsigned int>(cell.y * dims.x + cell.x);
+	if (cell_start[index] == cell_start[index + 1])
+		return ECS::Entity::null();
+	return cell_tiles[cell_start[index]];
+}
 
-			// motion_j can be square, circle (later might be egg shaped)
+ivec2 TileGrid::cell_of(vec2 point) const
+{
+	// The origin is a tile center, so rounding centers every cell on one lattice point
+	ivec2 cell = ivec2(glm::floor((point - origin) / tileSize + 0.5f));
+	return glm::clamp(cell, ivec2(0), dims - 1);
+}
 
-			// temporarily egg is considered a circle and follows circle/circle and circle/square collisions, 
-			// in m3 we need to implement precise collision with the egg mesh and handle the collision check differently
-			if (motion_j.shape == "square")
-			{
-				// Blobule vs Tile
-				Direction collisionEdge = box_circle_collides(motion_j, blob_motion_i);
-				if (collisionEdge != Direction::unknown)
-				{
-					auto& collision = ECS::registry<Collision>.emplace_with_duplicates(blob_entity_i, entity_j);
-					collision.direction = collisionEdge;
-				}
-			}
-			else if (motion_j.shape == "circle")
-			{
-				// Blobule vs Blobule
-				if (circle_circle_collides(blob_motion_i, motion_j) && !(detectedBlobs.find(blob_entity_i.id) != detectedBlobs.end() && detectedBlobs.find(entity_j.id) != detectedBlobs.end()))
-				{
-					ECS::registry<Collision>.emplace_with_duplicates(blob_entity_i, entity_j);
-					detectedBlobs.insert(blob_entity_i.id);
-					detectedBlobs.insert(entity_j.id);
-				}
-			}
+// Applies friction, zeroes velocities below the rest speed and moves the bodies begin to end, four at a time where SSE2 is available
+void integrate_bodies(size_t begin, size_t end, float* position_x, float* position_y, float* velocity_x, float* velocity_y,
+	const float* friction, const float* rest_speed_squared, float step_seconds)
+{
+	size_t i = begin;
+#ifdef PHYSICS_SSE2
+	const __m128 step = _mm_set1_ps(step_seconds);
+	for (; i + 4 <= end; i += 4)
+	{
+		__m128 vx = _mm_loadu_ps(velocity_x + i);
+		__m128 vy = _mm_loadu_ps(velocity_y + i);
+		const __m128 f = _mm_loadu_ps(friction + i);
+		vx = _mm_sub_ps(vx, _mm_mul_ps(vx, f));
+		vy = _mm_sub_ps(vy, _mm_mul_ps(vy, f));
+		const __m128 speed_squared = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+		const __m128 moving = _mm_cmpge_ps(speed_squared, _mm_loadu_ps(rest_speed_squared + i));
+		vx = _mm_and_ps(vx, moving);
+		vy = _mm_and_ps(vy, moving);
+		_mm_storeu_ps(velocity_x + i, vx);
+		_mm_storeu_ps(velocity_y + i, vy);
+		_mm_storeu_ps(position_x + i, _mm_add_ps(_mm_loadu_ps(position_x + i), _mm_mul_ps(step, vx)));
+		_mm_storeu_ps(position_y + i, _mm_add_ps(_mm_loadu_ps(position_y + i), _mm_mul_ps(step, vy)));
+	}
+#endif
+	for (; i < end; i++)
+	{
+		velocity_x[i] -= velocity_x[i] * friction[i];
+		velocity_y[i] -= velocity_y[i] * friction[i];
+		if (velocity_x[i] * velocity_x[i] + velocity_y[i] * velocity_y[i] < rest_speed_squared[i])
+		{
+			velocity_x[i] = 0.f;
+			velocity_y[i] = 0.f;
 		}
+		position_x[i] += step_seconds * velocity_x[i];
+		position_y[i] += step_seconds * velocity_y[i];
 	}
+}
 
-	auto& egg_container = ECS::registry<Egg>;
-	for (unsigned int i = 0; i < egg_container.components.size(); i++)
+// Appends (i, j) for every circle j from first to count overlapping circle i, one pair at a time
+void overlapping_circles_from(unsigned int i, unsigned int first, const float* x, const float* y, const float* radius, unsigned int count,
+	std::vector<std::pair<unsigned int, unsigned int>>& pairs)
+{
+	for (unsigned int j = first; j < count; j++)
 	{
-		ECS::Entity egg_entity_i = egg_container.entities[i];
-		Motion& egg_motion_i = ECS::registry<Motion>.get(egg_entity_i);
+		const float dx = x[i] - x[j];
+		const float dy = y[i] - y[j];
+		const float reach = radius[i] + radius[j];
+		if (reach > 0.f && dx * dx + dy * dy < reach * reach)
+			pairs.emplace_back(i, j);
+	}
+}
 
-		for (unsigned int j = 0; j < motion_container.components.size(); j++)
+void overlapping_circles_scalar(unsigned int i, const float* x, const float* y, const float* radius, unsigned int count,
+	std::vector<std::pair<unsigned int, unsigned int>>& pairs)
+{
+	overlapping_circles_from(i, i + 1, x, y, radius, count, pairs);
+}
+
+void overlapping_circles(unsigned int i, const float* x, const float* y, const float* radius, unsigned int count,
+	std::vector<std::pair<unsigned int, unsigned int>>& pairs)
+{
+	unsigned int j = i + 1;
+#ifdef PHYSICS_SSE2
+	const __m128 xi = _mm_set1_ps(x[i]);
+	const __m128 yi = _mm_set1_ps(y[i]);
+	const __m128 ri = _mm_set1_ps(radius[i]);
+	const __m128 zero = _mm_setzero_ps();
+	for (; j + 4 <= count; j += 4)
+	{
+		const __m128 dx = _mm_sub_ps(xi, _mm_loadu_ps(x + j));
+		const __m128 dy = _mm_sub_ps(yi, _mm_loadu_ps(y + j));
+		const __m128 reach = _mm_add_ps(ri, _mm_loadu_ps(radius + j));
+		const __m128 distance_squared = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		// distance < reach, for a reach that can be negative in principle
+		const __m128 overlap = _mm_and_ps(_mm_cmpgt_ps(reach, zero), _mm_cmplt_ps(distance_squared, _mm_mul_ps(reach, reach)));
+		int mask = _mm_movemask_ps(overlap);
+		while (mask != 0)
 		{
-			Motion& motion_j = motion_container.components[j];
-			ECS::Entity entity_j = motion_container.entities[j];
+			const int lane = mask & 1 ? 0 : mask & 2 ? 1 : mask & 4 ? 2 : 3;
+			pairs.emplace_back(i, j + lane);
+			mask &= mask - 1;
+		}
+	}
+#endif
+	overlapping_circles_from(i, j, x, y, radius, count, pairs);
+}
 
-			if (entity_j.id == egg_entity_i.id) {
-				continue;
-			}
+void PhysicsSystem::CircleBatch::clear()
+{
+	entities.clear();
+	x.clear();
+	y.clear();
+	radius.clear();
+	outline_start.assign(1, 0);
+	outline_points.clear();
+}
 
-			// temporarily egg is considered a circle and follows circle/circle and circle/square collisions, 
-			// in m3 we need to implement precise collision with the egg mesh and handle the collision check differently
-			if (motion_j.shape == "square")
-			{
-				// Egg vs Tile
-				Direction collisionEdge = box_circle_collides(motion_j, egg_motion_i);
-				if (collisionEdge != Direction::unknown)
-				{
-					auto& collision = ECS::registry<Collision>.emplace_with_duplicates(egg_entity_i, entity_j);
-					collision.direction = collisionEdge;
-				}
-			}
-			else if (motion_j.shape == "circle")
+void PhysicsSystem::CircleBatch::push_back(ECS::Entity entity, const Motion& motion)
+{
+	// Appended to the scratch buffer, which keeps its capacity across steps
+	const unsigned int start = outline_start.back();
+	if (motion.shape == Shape::egg)
+		append_egg_outline(motion, outline_points);
+	outline_start.push_back(static_cast<unsigned int>(outline_points.size()));
+	entities.push_back(entity);
+	x.push_back(motion.position.x);
+	y.push_back(motion.position.y);
+	radius.push_back(bounding_radius(motion, { outline_points.data() + start, outline_points.size() - start }));
+}
+
+void PhysicsSystem::BodyBatch::clear()
+{
+	entities.clear();
+	position_x.clear();
+	position_y.clear();
+	velocity_x.clear();
+	velocity_y.clear();
+	friction.clear();
+	rest_speed_squared.clear();
+}
+
+void PhysicsSystem::BodyBatch::push_back(ECS::Entity entity, const Motion& motion, const RigidBody& body)
+{
+	const bool dynamic = body.type == BodyType::Dynamic;
+	entities.push_back(entity);
+	position_x.push_back(motion.position.x);
+	position_y.push_back(motion.position.y);
+	velocity_x.push_back(motion.velocity.x);
+	velocity_y.push_back(motion.velocity.y);
+	// Friction is the velocity lost per tuned step, converted to the loss per simulation step
+	const float retained = std::pow(1.f - glm::clamp(motion.friction, 0.f, 1.f), simulation_step_ms / tuned_step_ms);
+	friction.push_back(dynamic ? 1.f - retained : 0.f);
+	rest_speed_squared.push_back(dynamic ? terminalVelocity * terminalVelocity : 0.f);
+}
+
+void PhysicsSystem::gather_awake_bodies()
+{
+	awake.clear();
+	for (auto [entity, body, motion] : ECS::view<RigidBody, Motion>())
+	{
+		body.previous_position = motion.position;
+		if (motion.velocity.x != 0.f || motion.velocity.y != 0.f)
+			awake.push_back(entity, motion, body);
+	}
+}
+
+vec2 PhysicsSystem::clamp_to_first_impact(vec2 start, vec2 end, float radius) const
+{
+	const vec2 movement = end - start;
+	const float distance = length(movement);
+	if (distance == 0.f)
+		return end;
+
+	// Earliest impact with a Block or Water tile along the way, tiles the body already touches are left to the collision handling
+	float first_toi = 1.f;
+	tile_grid.query(glm::min(start, end) - radius, glm::max(start, end) + radius, [&](ECS::Entity tile, const Motion& tile_motion) {
+		if (!ECS::registry<Terrain>().has(tile))
+			return;
+		const TerrainType type = ECS::registry<Terrain>().get(tile).type;
+		if (type != Block && type != Water)
+			return;
+		const vec2 half = abs(tile_motion.scale) / 2.f;
+		float toi;
+		if (Utils::sweepCircleAabb(start, end, radius, tile_motion.position - half, tile_motion.position + half, toi) && toi > 0.f)
+			first_toi = std::min(first_toi, toi);
+	});
+	if (first_toi >= 1.f)
+		return end;
+	// Stop 1 px into the tile, such that the collision checks below report the contact in this step
+	return start + std::min(1.f, first_toi + 1.f / distance) * movement;
+}
+
+PhysicsSystem::PhysicsSystem(ECS::World& world) : world(world)
+{
+}
+
+void PhysicsSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
+{
+	ECS::World::Scope scope(world);
+	// Move entities based on how much time has passed, this is to (partially) avoid
+	// having entities move at different speed based on the machine.
+
+	contacts.begin_step();
+
+	// Only bodies that are moving are integrated, tiles, splats and UI never are
+	float step_seconds = 1.0f * (elapsed_ms / 1000.f);
+	gather_awake_bodies();
+	JobSystem::instance().parallel_for(awake.size(), BODY_CHUNK_SIZE, [&](size_t begin, size_t end) {
+		integrate_bodies(begin, end, awake.position_x.data(), awake.position_y.data(), awake.velocity_x.data(), awake.velocity_y.data(),
+			awake.friction.data(), awake.rest_speed_squared.data(), step_seconds);
+	});
+	// Write the new state back, stopping each body at the first wall along its way
+	tile_grid.update();
+	auto& motion_container = ECS::registry<Motion>();
+	for (size_t i = 0; i < awake.size(); i++)
+	{
+		Motion& motion = motion_container.get(awake.entities[i]);
+		const vec2 start = motion.position;
+		const vec2 end = { awake.position_x[i], awake.position_y[i] };
+		motion.position = clamp_to_first_impact(start, end, abs(motion.scale.x) / 2.f);
+		motion.velocity = { awake.velocity_x[i], awake.velocity_y[i] };
+	}
+
+	(void)elapsed_ms; // placeholder to silence unused warning until implemented
+	(void)window_size_in_game_units;
+
+	// Visualization for debugging the position and scale of objects
+	if (DebugSystem::in_debug_mode)
+	{
+		/*for (auto& motion : ECS::registry<Motion>().components)
+		{
+			DebugSystem::createBox(motion.position, motion.scale);
+		}*/
+	}
+
+	// Go through the list of Blobules and Eggs rather than Motion
+	// For each of them check what its colliding with using the collision detection functions above, skipping itself (entity.id)
+
+	// Blobules and eggs only collide with tiles and with each other
+	auto& terrain_container = ECS::registry<Terrain>();
+	auto collider_of = [&](unsigned int i) {
+		const vec2* outline = circles.outline(i);
+		return Collider{ motion_container.get(circles.entities[i]), circles.radius[i],
+			{ outline, circles.outline_start[i + 1] - circles.outline_start[i] } };
+	};
+	auto collide_tiles = [&](unsigned int i) {
+		const Collider collider_i = collider_of(i);
+		const ECS::Entity entity_i = circles.entities[i];
+		const Motion& motion_i = collider_i.motion;
+		// The other tiles only act through the terrain under the body's center
+		const ECS::Entity tile = tile_grid.tile_at(motion_i.position);
+		if (ECS::valid(tile))
+			terrain.push_back({ entity_i, tile });
+
+		// Blobule or egg vs Block or Water tile, only the tiles in the cells around the body reach the narrowphase
+		const vec2 half_extent = vec2(std::max(abs(motion_i.scale.x), abs(motion_i.scale.y)) / 2.f);
+		tile_grid.query(motion_i.position - half_extent, motion_i.position + half_extent, [&](ECS::Entity entity_j, const Motion& motion_j) {
+			if (!terrain_container.has(entity_j))
+				return;
+			const TerrainType type = terrain_container.get(entity_j).type;
+			if (type != Block && type != Water)
+				return;
+			Direction collisionEdge;
+			Penetration penetration;
+			if (shapes_collide(collider_i, { motion_j, bounding_radius(motion_j, { nullptr, 0 }), { nullptr, 0 } }, collisionEdge, penetration))
 			{
-				// Blobule vs Blobule
-				if (circle_circle_collides(egg_motion_i, motion_j) && !(detectedBlobs.find(egg_entity_i.id) != detectedBlobs.end() && detectedBlobs.find(entity_j.id) != detectedBlobs.end()))
-				{
-					ECS::registry<Collision>.emplace_with_duplicates(egg_entity_i, entity_j);
-					detectedBlobs.insert(egg_entity_i.id);
-					detectedBlobs.insert(entity_j.id);
-				}
+				contacts.add(entity_i, entity_j, collisionEdge, penetration);
 			}
+		});
+	};
+	// Gathers the bodies first, such that every egg outline is transformed once for all the tests below
+	terrain.clear();
+	circles.clear();
+	for (auto [blob_entity_i, blob_motion_i, blob] : ECS::view<Motion, Blobule>())
+	{
+		circles.push_back(blob_entity_i, blob_motion_i);
+	}
+	for (auto [egg_entity_i, egg_motion_i, egg] : ECS::view<Motion, Egg>())
+	{
+		circles.push_back(egg_entity_i, egg_motion_i);
+	}
+	for (unsigned int i = 0; i < circles.size(); i++)
+	{
+		collide_tiles(i);
+	}
 
+	// Blobule or egg vs Blobule or egg, every pair whose bounding circles overlap once with the earlier body first,
+	// i.e., the blobule of a blobule-egg pair, then the exact test for their shapes
+	circle_pairs.clear();
+	for (unsigned int i = 0; i < circles.size(); i++)
+	{
+		overlapping_circles(i, circles.x.data(), circles.y.data(), circles.radius.data(), static_cast<unsigned int>(circles.size()), circle_pairs);
+	}
+	for (auto [i, j] : circle_pairs)
+	{
+		Direction direction;
+		Penetration penetration;
+		if (shapes_collide(collider_of(i), collider_of(j), direction, penetration))
+		{
+			contacts.add(circles.entities[i], circles.entities[j], direction, penetration);
 		}
 	}
+	contacts.end_step();
+}
+
+unsigned long long ContactBuffer::key(ECS::Entity entity, ECS::Entity other)
+{
+	// The same for both orders, the order bodies are gathered in can change between steps (e.g., after a swap-remove)
+	const unsigned int low = std::min(entity.id, other.id);
+	const unsigned int high = std::max(entity.id, other.id);
+	return (static_cast<unsigned long long>(low) << 32) | high;
 }
 
+void ContactBuffer::begin_step()
+{
+	// Only the contacts that touched are carried over, those that ended are gone for good
+	previous.clear();
+	previous_keys.clear();
+	for (const Contact& contact : current)
+	{
+		if (contact.phase != ContactPhase::end)
+			previous.push_back(contact);
+	}
+	std::sort(previous.begin(), previous.end(), [](const Contact& a, const Contact& b) { return key(a.entity, a.other) < key(b.entity, b.other); });
+	for (const Contact& contact : previous)
+		previous_keys.push_back(key(contact.entity, contact.other));
+	current.clear();
+	current_keys.clear();
+}
 
+void ContactBuffer::add(ECS::Entity entity, ECS::Entity other, Direction direction, Penetration penetration)
+{
+	current.push_back({ entity, other, direction, ContactPhase::begin, penetration });
+	current_keys.push_back(key(entity, other));
+}
 
-PhysicsSystem::Collision::Collision(ECS::Entity& other)
+void ContactBuffer::end_step()
 {
-	this->other = other;
+	// Drop pairs reported twice, keeping the first report
+	sorted_keys.assign(current_keys.begin(), current_keys.end());
+	std::sort(sorted_keys.begin(), sorted_keys.end());
+	if (std::adjacent_find(sorted_keys.begin(), sorted_keys.end()) != sorted_keys.end())
+	{
+		seen.clear();
+		size_t kept = 0;
+		for (size_t i = 0; i < current.size(); i++)
+		{
+			auto position = std::lower_bound(seen.begin(), seen.end(), current_keys[i]);
+			if (position != seen.end() && *position == current_keys[i])
+				continue;
+			seen.insert(position, current_keys[i]);
+			current[kept] = current[i];
+			current_keys[kept] = current_keys[i];
+			kept++;
+		}
+		current.resize(kept);
+		current_keys.resize(kept);
+		sorted_keys.erase(std::unique(sorted_keys.begin(), sorted_keys.end()), sorted_keys.end());
+	}
+
+	for (size_t i = 0; i < current.size(); i++)
+	{
+		if (std::binary_search(previous_keys.begin(), previous_keys.end(), current_keys[i]))
+			current[i].phase = ContactPhase::stay;
+	}
+	for (size_t i = 0; i < previous.size(); i++)
+	{
+		if (!std::binary_search(sorted_keys.begin(), sorted_keys.end(), previous_keys[i]))
+		{
+			Contact ended = previous[i];
+			ended.phase = ContactPhase::end;
+			current.push_back(ended);
+		}
+	}
 }
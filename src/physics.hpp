@@ -3,6 +3,9 @@
 #include "common.hpp"
 #include "tiny_ecs.hpp"
 
+#include <utility>
+#include <vector>
+
 enum class Direction {
 	unknown = 0,
 	Left,
@@ -12,21 +15,168 @@ enum class Direction {
 	Corner
 };
 
+// Broadphase for the tiles, which sit on a regular tileSize lattice. Every tile is binned into the cell of its center,
+// so finding the tiles near a body only visits the few cells around it instead of every Motion.
+class TileGrid
+{
+public:
+	// Rebuilds the cells when tiles were added or removed since the last update
+	void update();
+
+	// Calls fn(tile_entity, tile_motion) for every tile that may overlap the box from min to max
+	template <typename Function>
+	void query(vec2 min, vec2 max, Function fn) const
+	{
+		if (cell_tiles.empty())
+			return;
+		// Moving the camera moves all tiles by the same offset, so the grid follows the anchor tile instead of being rebuilt
+		const vec2 offset = ECS::registry<Motion>().get(anchor).position - anchor_position;
+		const ivec2 first = cell_of(min - offset - max_half_extent);
+		const ivec2 last = cell_of(max - offset + max_half_extent);
+		for (int y = first.y; y <= last.y; y++)
+		{
+			for (int x = first.x; x <= last.x; x++)
+			{
+				const unsigned int cell = static_cast<unsigned int>(y * dims.x + x);
+				for (unsigned int i = cell_start[cell]; i < cell_start[cell + 1]; i++)
+					fn(cell_tiles[i], ECS::registry<Motion>().get(cell_tiles[i]));
+			}
+		}
+	}
+
+	// The tile centered in the cell that contains the point, i.e., the tile under it, or null off the island. A single cell lookup.
+	ECS::Entity tile_at(vec2 point) const;
+
+private:
+	// Cell containing the point, clamped to the grid
+	ivec2 cell_of(vec2 point) const;
+
+	unsigned int built_version = ~0u; // Tile structure version the cells were built for
+	ECS::Entity anchor = ECS::Entity::null();
+	vec2 anchor_position = { 0.f, 0.f }; // where the anchor tile was when the cells were built
+	vec2 origin = { 0.f, 0.f };
+	ivec2 dims = { 0, 0 };
+	float max_half_extent = 0.f;
+	std::vector<unsigned int> cell_start; // the tiles of cell c are cell_tiles[cell_start[c]] to cell_tiles[cell_start[c + 1]]
+	std::vector<ECS::Entity> cell_tiles;
+};
+
+// When a contact between two entities happened, relative to the previous simulation step
+enum class ContactPhase { begin, stay, end };
+
+// How deep entity is inside other, moving entity by normal * depth separates them. Only set for contacts with eggs, whose
+// hull is tested with separating axes, and zero otherwise.
+struct Penetration
+{
+	vec2 normal = { 0.f, 0.f };
+	float depth = 0.f;
+};
+
+// The contacts of one simulation step as a flat array, in the order they were found. A pair of entities is identified by a key
+// that stays the same across steps whichever of the two is reported first, which tells contacts that begin apart from those
+// that stay, and finds those that ended. Each contact keeps the entity and other of the report it came from.
+class ContactBuffer
+{
+public:
+	struct Contact
+	{
+		ECS::Entity entity; // the body that was tested
+		ECS::Entity other; // what it touches
+		Direction direction; // side of other that is touched, if other is a box
+		ContactPhase phase;
+		Penetration penetration;
+	};
+
+	// Forgets the contacts of the last step, keeping their pairs to compare against
+	void begin_step();
+	// Records a contact, a pair reported twice in one step is kept once
+	void add(ECS::Entity entity, ECS::Entity other, Direction direction, Penetration penetration = {});
+	// Assigns begin or stay to this step's contacts and appends an end contact for every pair of the last step that is gone
+	void end_step();
+
+	const std::vector<Contact>& contacts() const { return current; }
+
+private:
+	static unsigned long long key(ECS::Entity entity, ECS::Entity other);
+
+	std::vector<Contact> current;
+	std::vector<unsigned long long> current_keys; // key of each contact in current
+	std::vector<unsigned long long> previous_keys; // sorted
+	std::vector<Contact> previous; // the pairs and directions of previous_keys, in the same order
+	// Scratch space of end_step, kept such that a step does not allocate once the buffers have grown
+	std::vector<unsigned long long> sorted_keys;
+	std::vector<unsigned long long> seen;
+};
+
+// Appends (i, j) for every circle j > i overlapping circle i, for circles given as structure of arrays. Tests four circles
+// per instruction where SSE2 is available, overlapping_circles_scalar tests one at a time and finds the same pairs.
+void overlapping_circles(unsigned int i, const float* x, const float* y, const float* radius, unsigned int count,
+	std::vector<std::pair<unsigned int, unsigned int>>& pairs);
+void overlapping_circles_scalar(unsigned int i, const float* x, const float* y, const float* radius, unsigned int count,
+	std::vector<std::pair<unsigned int, unsigned int>>& pairs);
+
+// The tile under the center of a blobule or egg, which decides the terrain effects on it
+struct TerrainSample
+{
+	ECS::Entity entity;
+	ECS::Entity tile;
+};
+
 // A simple physics system that moves rigid bodies and checks for collision
 class PhysicsSystem
 {
 public:
+	// Moves the bodies of world
+	explicit PhysicsSystem(ECS::World& world = ECS::World::main());
+
 	void step(float elapsed_ms, vec2 window_size_in_game_units);
 
 	static bool is_entity_clicked(ECS::Entity e, float mouse_press_x, float mouse_press_y);
 
-	// Stucture to store collision information
-	struct Collision
+	// The contacts found by the last step, tiles only touch bodies as walls (Block and Water)
+	ContactBuffer contacts;
+	// The tile under each blobule and egg after the last step, bodies off the island have none
+	std::vector<TerrainSample> terrain;
+
+private:
+	ECS::World& world;
+
+	// The awake bodies as structure of arrays for the integration kernel, kept between steps to re-use the allocations
+	struct BodyBatch
 	{
-		// Note, the first object is stored in the ECS container.entities
-		ECS::Entity other; // the second object involved in the collision
-		Direction direction;
-		Collision(ECS::Entity& other);
+		std::vector<ECS::Entity> entities;
+		std::vector<float> position_x, position_y, velocity_x, velocity_y;
+		std::vector<float> friction;
+		std::vector<float> rest_speed_squared; // velocities below this are zeroed, 0 for kinematic bodies
+		void clear();
+		void push_back(ECS::Entity entity, const Motion& motion, const RigidBody& body);
+		size_t size() const { return entities.size(); }
 	};
+
+	// Bounding circles of the blobules and eggs as structure of arrays for the circle overlap kernel,
+	// with the world space outlines of the eggs for the narrowphase
+	struct CircleBatch
+	{
+		std::vector<ECS::Entity> entities;
+		std::vector<float> x, y, radius;
+		std::vector<unsigned int> outline_start = { 0 }; // the outline of body i is outline_points[outline_start[i]] to outline_points[outline_start[i + 1]]
+		std::vector<vec2> outline_points;
+		void clear();
+		void push_back(ECS::Entity entity, const Motion& motion);
+		size_t size() const { return entities.size(); }
+		const vec2* outline(size_t i) const { return outline_points.data() + outline_start[i]; }
+	};
+
+	// Remembers every body's position for interpolation and collects the bodies that are moving,
+	// resting bodies are skipped until something gives them a velocity again
+	void gather_awake_bodies();
+
+	// Where a circle moving from start to end first hits a Block or Water tile, so fast bodies cannot pass through thin walls
+	vec2 clamp_to_first_impact(vec2 start, vec2 end, float radius) const;
+
+	TileGrid tile_grid;
+	BodyBatch awake;
+	CircleBatch circles;
+	std::vector<std::pair<unsigned int, unsigned int>> circle_pairs; // indices into circles
 };
  
\ No newline at end of file
@@ -16,79 +16,84 @@ std::string BIG_POWERUP = "bigboi";
 std::string SMALL_POWERUP = "smolboi";
 std::string COLOR_SWAP_POWERUP = "colorswitcharoo";
 
-void bigPowerup(ECS::Entity entity, PowerupSystem::Powerup& powerup)
+void bigPowerup(ECS::Entity entity, PowerupSystem::Powerup& powerup, ECS::CommandBuffer& commands)
 {
     if (powerup.duration == -1)
     {
         powerup.duration = current_turn + 5;
-        Motion& motion = ECS::registry<Motion>.get(entity);
+        Motion& motion = ECS::registry<Motion>().get(entity);
         motion.scale *= vec2(1.5f, 1.5f);
     }
 
     else if (current_turn == powerup.duration)
     {
-        Motion& motion = ECS::registry<Motion>.get(entity);
+        Motion& motion = ECS::registry<Motion>().get(entity);
         motion.scale /= vec2(1.5f, 1.5f);
-        ECS::registry<PowerupSystem::Powerup>.remove(entity);
+        commands.remove<PowerupSystem::Powerup>(entity);
     }
 }
 
-void smallPowerup(ECS::Entity entity, PowerupSystem::Powerup& powerup)
+void smallPowerup(ECS::Entity entity, PowerupSystem::Powerup& powerup, ECS::CommandBuffer& commands)
 {
     if (powerup.duration == -1)
     {
         powerup.duration = current_turn + 5;
-        Motion& motion = ECS::registry<Motion>.get(entity);
+        Motion& motion = ECS::registry<Motion>().get(entity);
         motion.scale *= vec2(0.7f, 0.7f);
     }
 
     else if (current_turn == powerup.duration)
     {
-        Motion& motion = ECS::registry<Motion>.get(entity);
+        Motion& motion = ECS::registry<Motion>().get(entity);
         motion.scale /= vec2(0.7f, 0.7f);
-        ECS::registry<PowerupSystem::Powerup>.remove(entity);
+        commands.remove<PowerupSystem::Powerup>(entity);
     }
 }
 
-void colorSwapPowerup(ECS::Entity entity)
+void colorSwapPowerup(ECS::Entity entity, ECS::CommandBuffer& commands)
 {
-    for (ECS::Entity entity : ECS::registry<Tile>.entities)
-    {
-        Tile::setRandomSplat(entity);
-    }
-    ECS::registry<PowerupSystem::Powerup>.remove(entity);
+    // Repainting replaces the splats' components, and splat textures are created on first use, which needs the GL context
+    commands.defer([]() {
+        for (ECS::Entity entity : ECS::registry<Tile>().entities)
+        {
+            Tile::setRandomSplat(entity);
+        }
+    });
+    commands.remove<PowerupSystem::Powerup>(entity);
 }
 
-void PowerupSystem::handle_powerups()
+PowerupSystem::PowerupSystem(ECS::World& world) : world(world)
 {
-	// Loop over all collisions detected by the physics system
-	auto& registry = ECS::registry<PowerupSystem::Powerup>;
-	for (auto& entity : ECS::registry<PowerupSystem::Powerup>.entities)
-	{
-		PowerupSystem::Powerup& powerup = ECS::registry<PowerupSystem::Powerup>.get(entity);
+}
 
+void PowerupSystem::handle_powerups(ECS::CommandBuffer& commands)
+{
+	ECS::World::Scope scope(world);
+	// Expired powerups are removed on flush, removing them right away would skip the next powerup
+	for (auto [entity, powerup] : ECS::view<PowerupSystem::Powerup>())
+	{
 		// create random powerup
 		if (powerup.power == BIG_POWERUP)
 		{
-            bigPowerup(entity, powerup);
+            bigPowerup(entity, powerup, commands);
 		}
 
         if (powerup.power == SMALL_POWERUP)
         {
-            smallPowerup(entity, powerup);
+            smallPowerup(entity, powerup, commands);
         }
 
         if (powerup.power == COLOR_SWAP_POWERUP)
         {
-            colorSwapPowerup(entity);
+            colorSwapPowerup(entity, commands);
         }
 	}
 }
 
-void PowerupSystem::Powerup::createPowerup(ECS::Entity& entity)
+void PowerupSystem::Powerup::createPowerup(ECS::Entity entity, ECS::CommandBuffer& commands)
 {
     int curr_powerup = 0 + (std::rand() % (NUM_POWERUPS - 1 - 0 + 1));
-	PowerupSystem::Powerup& powerup = ECS::registry<PowerupSystem::Powerup>.emplace(entity);
+	PowerupSystem::Powerup powerup;
 	powerup.owner = entity;
     switch (curr_powerup) {
         case 0:
@@ -103,4 +108,21 @@ void PowerupSystem::Powerup::createPowerup(ECS::Entity& entity)
             powerup.power = COLOR_SWAP_POWERUP;
             break;
     }
+    commands.emplace<PowerupSystem::Powerup>(entity, std::move(powerup));
+}
+
+void ECS::Serializer<PowerupSystem::Powerup>::write(ECS::SnapshotWriter& out, const PowerupSystem::Powerup& powerup)
+{
+    out.write(powerup.owner);
+    out.write(powerup.power);
+    out.write(powerup.duration);
+}
+
+PowerupSystem::Powerup ECS::Serializer<PowerupSystem::Powerup>::read(ECS::SnapshotReader& in)
+{
+    PowerupSystem::Powerup powerup;
+    in.read(powerup.owner);
+    in.read(powerup.power);
+    in.read(powerup.duration);
+    return powerup;
 }
@@ -10,17 +10,30 @@
 class PowerupSystem
 {
 public:
-    void handle_powerups();
+    // Handles the powerups of world
+    explicit PowerupSystem(ECS::World& world = ECS::World::main());
+
+    // Expired powerups are removed through commands
+    void handle_powerups(ECS::CommandBuffer& commands);
 
     // Stucture to store collision information
     struct Powerup
     {
-        ECS::Entity owner;     
-        static void createPowerup(ECS::Entity& entity);
+        ECS::Entity owner = ECS::Entity::null();
+        // Gives the entity a random powerup when commands are flushed
+        static void createPowerup(ECS::Entity entity, ECS::CommandBuffer& commands);
         std::string power = "none";
         int duration = -1;
     };
 
 private:
+    ECS::World& world;
+};
+
+template <> struct ECS::Serializer<PowerupSystem::Powerup>
+{
+    static constexpr bool available = true;
+    static void write(ECS::SnapshotWriter& out, const PowerupSystem::Powerup& powerup);
+    static PowerupSystem::Powerup read(ECS::SnapshotReader& in);
 };
 
@@ -16,12 +16,15 @@ float frame_number = 1.f; // Start all sprite sheets at first frame
 
 void RenderSystem::drawTexturedMesh(ECS::Entity entity, const mat3& projection)
 {
-	auto& motion = ECS::registry<Motion>.get(entity);
-	auto& texmesh = *ECS::registry<ShadedMeshRef>.get(entity).reference_to_cache;
+	auto& motion = ECS::registry<Motion>().get(entity);
+	auto& texmesh = *ECS::registry<ShadedMeshRef>().get(entity).reference_to_cache;
 	// Transformation code, see Rendering and Transformation in the template specification for more info
 	// Incrementally updates transformation matrix, thus ORDER IS IMPORTANT
+	vec2 position = motion.position;
+	if (ECS::registry<RigidBody>().has(entity))
+		position = mix(ECS::registry<RigidBody>().get(entity).previous_position, position, interpolation);
 	Transform transform;
-	transform.translate(motion.position);
+	transform.translate(position);
 	transform.rotate(motion.angle);
 	transform.scale(motion.scale);
 
@@ -52,7 +55,7 @@ void RenderSystem::drawTexturedMesh(ECS::Entity entity, const mat3& projection)
 		vertices[3].position = { -1.f / 2, -1.f / 2, 0.f };
 
 		// Blobule specific animations
-		if (ECS::registry<Blobule>.has(entity))
+		if (ECS::registry<Blobule>().has(entity))
 		{
 			// If the blobule is moving we're using the first row in the sprite sheet
 			if (abs(motion.velocity.x) > 0.f || abs(motion.velocity.y) > 0.f)
@@ -163,7 +166,7 @@ void RenderSystem::drawToScreen()
 	GLuint time_uloc       = glGetUniformLocation(screen_sprite.effect.program, "time");
 	GLuint dead_timer_uloc = glGetUniformLocation(screen_sprite.effect.program, "darken_screen_factor");
 	glUniform1f(time_uloc, static_cast<float>(glfwGetTime() * 10.0f));
-	auto& screen = ECS::registry<ScreenState>.get(screen_state_entity);
+	auto& screen = ECS::registry<ScreenState>().get(screen_state_entity);
 	glUniform1f(dead_timer_uloc, screen.darken_screen_factor);
 	gl_has_errors();
 
@@ -188,8 +191,55 @@ void RenderSystem::drawToScreen()
 
 // Render our game world
 // http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
-void RenderSystem::draw(float elapsed_ms, vec2 window_size_in_game_units)
+void RenderSystem::updateLayers()
 {
+	// The versions only grow, so their sum changes whenever any of the containers deciding the layer changed
+	const unsigned long long version =
+		static_cast<unsigned long long>(ECS::registry<ShadedMeshRef>().structure_version()) +
+		ECS::registry<HelpTool>().structure_version() + ECS::registry<Button>().structure_version() + ECS::registry<Settings>().structure_version() +
+		ECS::registry<Blobule>().structure_version() + ECS::registry<Egg>().structure_version() + ECS::registry<DebugComponent>().structure_version() +
+		ECS::registry<BlueSplat>().structure_version() + ECS::registry<RedSplat>().structure_version() +
+		ECS::registry<YellowSplat>().structure_version() + ECS::registry<GreenSplat>().structure_version();
+	if (version == layers_version)
+		return;
+	layers_version = version;
+
+	overlay.clear();
+	firstEntities.clear();
+	debugEntities.clear();
+	secondEntities.clear();
+	thirdEntities.clear();
+
+	for (ECS::Entity entity : ECS::registry<ShadedMeshRef>().entities)
+	{
+		if (ECS::registry<HelpTool>().has(entity)) {
+			overlay.push_back(entity);
+		}
+		if (ECS::registry<Button>().has(entity)) {
+			overlay.push_back(entity);
+		}
+		if (ECS::registry<Settings>().has(entity)) {
+			overlay.push_back(entity);
+		}
+		if (ECS::registry<Blobule>().has(entity) || ECS::registry<Egg>().has(entity)) {
+			firstEntities.push_back(entity);
+		}
+		else if (ECS::registry<BlueSplat>().has(entity) || ECS::registry<RedSplat>().has(entity) || ECS::registry<YellowSplat>().has(entity) || ECS::registry<GreenSplat>().has(entity)) {
+			secondEntities.push_back(entity);
+		}
+		else if (ECS::registry<DebugComponent>().has(entity))
+		{
+			debugEntities.push_back(entity);
+		}
+		else {
+			thirdEntities.push_back(entity);
+		}
+	}
+}
+
+void RenderSystem::draw(float elapsed_ms, vec2 window_size_in_game_units, float interpolation)
+{
+	this->interpolation = interpolation;
 	time_elapsed += elapsed_ms;
 	if (time_elapsed > ANIMATION_FREQUENCY) {
 		time_elapsed = 0.f;
@@ -227,41 +277,12 @@ void RenderSystem::draw(float elapsed_ms, vec2 window_size_in_game_units)
 	float ty = -(top + bottom) / (top - bottom);
 	mat3 projection_2D{ { sx, 0.f, 0.f },{ 0.f, sy, 0.f },{ tx, ty, 1.f } };
 
-	std::vector<ECS::Entity> overlay;
-	std::vector<ECS::Entity> firstEntities;
-	std::vector<ECS::Entity> debugEntities;
-	std::vector<ECS::Entity> secondEntities;
-	std::vector<ECS::Entity> thirdEntities;
+	updateLayers();
 
-	for (ECS::Entity entity : ECS::registry<ShadedMeshRef>.entities)
-	{
-		if (ECS::registry<HelpTool>.has(entity)) {
-			overlay.push_back(entity);
-		}
-		if (ECS::registry<Button>.has(entity)) {
-			overlay.push_back(entity);
-		}
-		if (ECS::registry<Settings>.has(entity)) {
-			overlay.push_back(entity);
-		}
-		if (ECS::registry<Blobule>.has(entity) || ECS::registry<Egg>.has(entity)) {
-			firstEntities.push_back(entity);
-		}
-		else if (ECS::registry<BlueSplat>.has(entity) || ECS::registry<RedSplat>.has(entity) || ECS::registry<YellowSplat>.has(entity) || ECS::registry<GreenSplat>.has(entity)) {
-			secondEntities.push_back(entity);
-		}
-		else if (ECS::registry<DebugComponent>.has(entity))
-		{
-			debugEntities.push_back(entity);
-		}
-		else {
-			thirdEntities.push_back(entity);
-		}
-	}
 	// Renders tiles and other thirdlevel entities
 	for (ECS::Entity entity : thirdEntities)
 	{
-		if (!ECS::registry<Motion>.has(entity))
+		if (!ECS::registry<Motion>().has(entity))
 			continue;
 		// Note, its not very efficient to access elements indirectly via the entity albeit iterating through all Sprites in sequence
 		drawTexturedMesh(entity, projection_2D);
@@ -271,7 +292,7 @@ void RenderSystem::draw(float elapsed_ms, vec2 window_size_in_game_units)
 	// Renders splats and other second level entities
 	for (ECS::Entity entity : secondEntities)
 	{
-		if (!ECS::registry<Motion>.has(entity))
+		if (!ECS::registry<Motion>().has(entity))
 			continue;
 		// Note, its not very efficient to access elements indirectly via the entity albeit iterating through all Sprites in sequence
 		drawTexturedMesh(entity, projection_2D);
@@ -281,7 +302,7 @@ void RenderSystem::draw(float elapsed_ms, vec2 window_size_in_game_units)
 	// Renders debug level entities
 	for (ECS::Entity entity : debugEntities)
 	{
-		if (!ECS::registry<Motion>.has(entity))
+		if (!ECS::registry<Motion>().has(entity))
 			continue;
 		// Note, its not very efficient to access elements indirectly via the entity albeit iterating through all Sprites in sequence
 		drawTexturedMesh(entity, projection_2D);
@@ -291,7 +312,7 @@ void RenderSystem::draw(float elapsed_ms, vec2 window_size_in_game_units)
 	// renders blobs and eggs and other first level entities
 	for (ECS::Entity entity : firstEntities)
 	{
-		if (!ECS::registry<Motion>.has(entity))
+		if (!ECS::registry<Motion>().has(entity))
 			continue;
 		// Note, its not very efficient to access elements indirectly via the entity albeit iterating through all Sprites in sequence
 		drawTexturedMesh(entity, projection_2D);
@@ -301,7 +322,7 @@ void RenderSystem::draw(float elapsed_ms, vec2 window_size_in_game_units)
 	// renders helptool and other overlay level entities
 	for (ECS::Entity entity : overlay)
 	{
-		if (!ECS::registry<Motion>.has(entity))
+		if (!ECS::registry<Motion>().has(entity))
 			continue;
 		// Note, its not very efficient to access elements indirectly via the entity albeit iterating through all Sprites in sequence
 		drawTexturedMesh(entity, projection_2D);
@@ -314,7 +335,7 @@ void RenderSystem::draw(float elapsed_ms, vec2 window_size_in_game_units)
 	// for nearly all use cases. If you need text to appear behind meshes,
 	// consider using a depth buffer during rendering and adding a
 	// Z-component or depth index to all rendererable components.
-	for (const Text& text : ECS::registry<Text>.components) {
+	for (const Text& text : ECS::registry<Text>().components) {
 		drawText(text, window_size_in_game_units);
 	}
 
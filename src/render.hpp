@@ -21,8 +21,8 @@ public:
 	// Destroy resources associated to one or all entities created by the system
 	~RenderSystem();
 
-	// Draw all entities
-	void draw(float elapsed_ms, vec2 window_size_in_game_units);
+	// Draw all entities, bodies at interpolation (0 to 1) of the way from their previous to their current position
+	void draw(float elapsed_ms, vec2 window_size_in_game_units, float interpolation = 1.f);
 
 	// Expose the creating of visual representations to other systems
 	static void createSprite(ShadedMesh& mesh_container, std::string texture_path, std::string shader_name);
@@ -33,6 +33,9 @@ private:
 	// The draw loop first renders to this texture, then it is used for the water shader
 	void initScreenTexture();
 
+	// Sorts the drawable entities into the draw layers, only when entities were added or removed since the last call
+	void updateLayers();
+
 	// Internal drawing functions for each entity type
 	void drawTexturedMesh(ECS::Entity entity, const mat3& projection);
 	void drawToScreen();
@@ -40,9 +43,20 @@ private:
 	// Window handle
 	GLFWwindow& window;
 
+	// Of the frame being drawn, see draw()
+	float interpolation = 1.f;
+
 	// Screen texture handles
 	GLuint frame_buffer;
 	ShadedMesh screen_sprite;
 	GLResource<RENDER_BUFFER> depth_render_buffer_id;
 	ECS::Entity screen_state_entity;
+
+	// Drawable entities per layer, from back to front, and the container versions they were built from
+	std::vector<ECS::Entity> thirdEntities;
+	std::vector<ECS::Entity> secondEntities;
+	std::vector<ECS::Entity> debugEntities;
+	std::vector<ECS::Entity> firstEntities;
+	std::vector<ECS::Entity> overlay;
+	unsigned long long layers_version = ~0ull;
 };
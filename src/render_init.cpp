@@ -29,10 +29,10 @@ RenderSystem::~RenderSystem()
 	glDeleteFramebuffers(1, &frame_buffer);
 
 	// remove all entities created by the render system
-	while (ECS::registry<Motion>.entities.size() > 0)
-		ECS::ContainerInterface::remove_all_components_of(ECS::registry<Motion>.entities.back());
-	while (ECS::registry<ShadedMeshRef>.entities.size() > 0)
-		ECS::ContainerInterface::remove_all_components_of(ECS::registry<ShadedMeshRef>.entities.back());
+	while (ECS::registry<Motion>().entities.size() > 0)
+		ECS::ContainerInterface::destroy_entity(ECS::registry<Motion>().entities.back());
+	while (ECS::registry<ShadedMeshRef>().entities.size() > 0)
+		ECS::ContainerInterface::destroy_entity(ECS::registry<ShadedMeshRef>().entities.back());
 }
 
 // Create a new sprite and register it with ECS
@@ -113,5 +113,5 @@ void RenderSystem::initScreenTexture()
 
 	// Initialize the screen texture and its state
 	screen_sprite.texture.create_from_screen(&window, depth_render_buffer_id.data());
-	ECS::registry<ScreenState>.emplace(screen_state_entity);
+	ECS::registry<ScreenState>().emplace(screen_state_entity);
 }
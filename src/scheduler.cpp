@@ -0,0 +1,88 @@
+// Header
+#include "scheduler.hpp"
+#include "json.hpp"
+
+#include <cassert>
+#include <fstream>
+#include <iostream>
+
+Scheduler::Scheduler(JobSystem& jobs) :
+	jobs(jobs)
+{
+}
+
+unsigned int Scheduler::next_resource_id()
+{
+	static unsigned int counter = 0;
+	assert(counter < MAX_RESOURCES); // Raise MAX_RESOURCES
+	return counter++;
+}
+
+void Scheduler::add(std::string name, Access access, std::function<void(ECS::CommandBuffer&)> run)
+{
+	commands.push_back(std::make_unique<ECS::CommandBuffer>());
+	auto task = graph.add([this, name = std::move(name), run = std::move(run), &system_commands = *commands.back()]() {
+		const auto start = std::chrono::steady_clock::now();
+		run(system_commands);
+		const auto end = std::chrono::steady_clock::now();
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		trace.push_back({ name, JobSystem::current_thread(),
+			std::chrono::duration_cast<std::chrono::microseconds>(start - frame_start).count(),
+			std::chrono::duration_cast<std::chrono::microseconds>(end - frame_start).count() });
+	}, access.main_thread);
+	assert(task == accesses.size());
+	// Wait for every earlier system that touches the same components
+	for (TaskGraph::Task earlier = 0; earlier < task; earlier++)
+	{
+		if (accesses[earlier].conflicts(access))
+			graph.precede(earlier, task);
+	}
+	accesses.push_back(access);
+}
+
+void Scheduler::run()
+{
+	trace.clear();
+	frame_start = std::chrono::steady_clock::now();
+	graph.run(jobs);
+	// Only now, while no system runs, the entities and signatures change
+	const auto flush_start = std::chrono::steady_clock::now();
+	for (auto& system_commands : commands)
+		system_commands->flush();
+	trace.push_back({ "flush", JobSystem::current_thread(),
+		std::chrono::duration_cast<std::chrono::microseconds>(flush_start - frame_start).count(),
+		std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - frame_start).count() });
+	frame_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - frame_start).count();
+}
+
+float Scheduler::last_overlap() const
+{
+	if (frame_us <= 0)
+		return 1.f;
+	long long busy_us = 0;
+	for (const auto& event : trace)
+		busy_us += event.end_us - event.start_us;
+	return static_cast<float>(busy_us) / static_cast<float>(frame_us);
+}
+
+void Scheduler::save_trace(const std::string& path) const
+{
+	nlohmann::json events = nlohmann::json::array();
+	for (const auto& event : trace)
+	{
+		events.push_back({
+			{ "name", event.name },
+			{ "ph", "X" },
+			{ "pid", 0 },
+			{ "tid", event.thread },
+			{ "ts", event.start_us },
+			{ "dur", event.end_us - event.start_us }
+		});
+	}
+	nlohmann::json result;
+	result["traceEvents"] = events;
+	result["otherData"] = { { "frame_us", frame_us }, { "overlap", last_overlap() } };
+	std::ofstream file(path);
+	file << result.dump(4);
+	std::cout << "Saved schedule trace to " << path << " (overlap " << last_overlap() << ")" << std::endl;
+}
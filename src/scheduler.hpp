@@ -0,0 +1,121 @@
+#pragma once
+
+#include "common.hpp"
+#include "jobs.hpp"
+#include "tiny_ecs.hpp"
+
+#include <bitset>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Runs the systems of one frame, in parallel where their declared component access allows it.
+// Systems are added once in the order they would run sequentially. A system waits for every earlier system it conflicts with,
+// i.e., one of them writes a component type or resource that the other reads or writes, so the result is the same as running them one by one.
+// Systems never change entities or signatures directly, every system records its structural changes into a CommandBuffer of its own.
+// Once all systems finished, the buffers are flushed on the main thread in the order the systems were added.
+// The systems run as a TaskGraph on the shared JobSystem, so systems can use JobSystem::parallel_for themselves.
+class Scheduler
+{
+public:
+	static constexpr unsigned int MAX_RESOURCES = 32;
+	using ResourceSet = std::bitset<MAX_RESOURCES>;
+
+	// Shared state that is not a component, e.g., the ContactBuffer that PhysicsSystem fills for CollisionSystem.
+	// Numbered apart from the component types, such that declaring access to it takes up no ECS::Signature bit.
+	template <typename Resource>
+	static unsigned int resource_id()
+	{
+		static const unsigned int id = next_resource_id();
+		return id;
+	}
+
+	// The component types and resources a system reads and writes
+	class Access
+	{
+	public:
+		template <typename... Components>
+		Access& reads()
+		{
+			(read_set.set(ECS::component_type_id<Components>()), ...);
+			return *this;
+		}
+		template <typename... Components>
+		Access& writes()
+		{
+			(write_set.set(ECS::component_type_id<Components>()), ...);
+			return *this;
+		}
+		template <typename... Resources>
+		Access& reads_resources()
+		{
+			(read_resources.set(resource_id<Resources>()), ...);
+			return *this;
+		}
+		template <typename... Resources>
+		Access& writes_resources()
+		{
+			(write_resources.set(resource_id<Resources>()), ...);
+			return *this;
+		}
+		// Needs the main thread, e.g., for GLFW or OpenGL calls
+		Access& on_main_thread()
+		{
+			main_thread = true;
+			return *this;
+		}
+
+		bool conflicts(const Access& other) const
+		{
+			return (write_set & (other.read_set | other.write_set)).any() || (other.write_set & read_set).any() ||
+				(write_resources & (other.read_resources | other.write_resources)).any() || (other.write_resources & read_resources).any();
+		}
+
+		ECS::Signature read_set;
+		ECS::Signature write_set;
+		ResourceSet read_resources;
+		ResourceSet write_resources;
+		bool main_thread = false;
+	};
+
+	// Start and end of one system in the last frame, in microseconds since the frame started
+	struct TraceEvent
+	{
+		std::string name;
+		unsigned int thread; // JobSystem thread, 0 is the main thread
+		long long start_us;
+		long long end_us;
+	};
+
+	explicit Scheduler(JobSystem& jobs = JobSystem::instance());
+	Scheduler(const Scheduler&) = delete;
+	Scheduler& operator=(const Scheduler&) = delete;
+
+	// run records the system's structural changes into the given buffer
+	void add(std::string name, Access access, std::function<void(ECS::CommandBuffer&)> run);
+
+	// Runs all systems once and flushes their changes, returns when all of that finished. The calling thread is the main thread.
+	void run();
+
+	// What ran where in the last run(), and the sum of the system run times divided by the frame time (1 means no overlap)
+	const std::vector<TraceEvent>& last_trace() const { return trace; }
+	float last_overlap() const;
+	// Writes the last trace in the Chrome trace event format (chrome://tracing, Perfetto)
+	void save_trace(const std::string& path) const;
+
+private:
+	JobSystem& jobs;
+	TaskGraph graph;
+	std::vector<Access> accesses; // per system, in registration order
+	std::vector<std::unique_ptr<ECS::CommandBuffer>> commands; // per system, in registration order
+
+	static unsigned int next_resource_id();
+
+	std::chrono::steady_clock::time_point frame_start;
+	long long frame_us = 0;
+	std::mutex trace_mutex;
+	std::vector<TraceEvent> trace;
+};
@@ -23,20 +23,20 @@ bool background_music_on;
 
 //private functions
 void closeSettings() {
-	ECS::ContainerInterface::remove_all_components_of(ECS::registry<Button>.get(save_button).text_entity);
-	ECS::ContainerInterface::remove_all_components_of(ECS::registry<Button>.get(load_button).text_entity);
-	ECS::ContainerInterface::remove_all_components_of(ECS::registry<Button>.get(main_menu_button).text_entity);
-	ECS::ContainerInterface::remove_all_components_of(ECS::registry<Button>.get(restart_button).text_entity);
-	ECS::ContainerInterface::remove_all_components_of(save_button);
-	ECS::ContainerInterface::remove_all_components_of(load_button);
-	ECS::ContainerInterface::remove_all_components_of(exit_button);
-	ECS::ContainerInterface::remove_all_components_of(main_menu_button);
-	ECS::ContainerInterface::remove_all_components_of(restart_button);
-	ECS::ContainerInterface::remove_all_components_of(background_music_text);
-	ECS::ContainerInterface::remove_all_components_of(sound_effects_text);
-	ECS::ContainerInterface::remove_all_components_of(background_music_button);
-	ECS::ContainerInterface::remove_all_components_of(sound_effects_button);
-	ECS::ContainerInterface::remove_all_components_of(save_text);
+	ECS::ContainerInterface::destroy_entity(ECS::registry<Button>().get(save_button).text_entity);
+	ECS::ContainerInterface::destroy_entity(ECS::registry<Button>().get(load_button).text_entity);
+	ECS::ContainerInterface::destroy_entity(ECS::registry<Button>().get(main_menu_button).text_entity);
+	ECS::ContainerInterface::destroy_entity(ECS::registry<Button>().get(restart_button).text_entity);
+	ECS::ContainerInterface::destroy_entity(save_button);
+	ECS::ContainerInterface::destroy_entity(load_button);
+	ECS::ContainerInterface::destroy_entity(exit_button);
+	ECS::ContainerInterface::destroy_entity(main_menu_button);
+	ECS::ContainerInterface::destroy_entity(restart_button);
+	ECS::ContainerInterface::destroy_entity(background_music_text);
+	ECS::ContainerInterface::destroy_entity(sound_effects_text);
+	ECS::ContainerInterface::destroy_entity(background_music_button);
+	ECS::ContainerInterface::destroy_entity(sound_effects_button);
+	ECS::ContainerInterface::destroy_entity(save_text);
 }
 
 void enableSoundEffects() {
@@ -51,10 +51,10 @@ void enableSoundEffects() {
 
 	auto sound_effects_str = (sound_effects_on ? "Sound Effects: On" : "Sound Effects: Off");
 	auto sound_effect_buttonEnum = (sound_effects_on ? ButtonEnum::SoundOff : ButtonEnum::SoundOn);
-	auto sound_effect_pos = ECS::registry<Motion>.get(sound_effects_button).position;
-	auto& entity = ECS::registry<Text>.get(sound_effects_text);
+	auto sound_effect_pos = ECS::registry<Motion>().get(sound_effects_button).position;
+	auto& entity = ECS::registry<Text>().get(sound_effects_text);
 	entity.content = sound_effects_str;
-	ECS::ContainerInterface::remove_all_components_of(sound_effects_button);
+	ECS::ContainerInterface::destroy_entity(sound_effects_button);
 	sound_effects_button = Button::createButton({ sound_effect_pos.x, sound_effect_pos.y}, { 0.77, 0.77 }, sound_effect_buttonEnum, "");
 }
 
@@ -71,10 +71,10 @@ void enableBackgroundMusic() {
 
 	auto background_music_str = (background_music_on ? "Background Music: On" : "Background Music: Off");
 	auto background_music_buttonEnum = (background_music_on ? ButtonEnum::SoundOff : ButtonEnum::SoundOn);
-	auto background_music_pos = ECS::registry<Motion>.get(background_music_button).position;
-	auto& entity = ECS::registry<Text>.get(background_music_text);
+	auto background_music_pos = ECS::registry<Motion>().get(background_music_button).position;
+	auto& entity = ECS::registry<Text>().get(background_music_text);
 	entity.content = background_music_str;
-	ECS::ContainerInterface::remove_all_components_of(background_music_button);
+	ECS::ContainerInterface::destroy_entity(background_music_button);
 	background_music_button = Button::createButton({ background_music_pos.x, background_music_pos.y }, { 0.77, 0.77 }, background_music_buttonEnum, "");
 }
 
@@ -87,7 +87,7 @@ void saveGame() {
 		}
 	}
 	MapLoader::saveMap(currPlayer, WorldSystem::get_current_turn());
-	auto& entity = ECS::registry<Text>.get(save_text);
+	auto& entity = ECS::registry<Text>().get(save_text);
 	entity.content = "Save Complete";
 
 }
@@ -110,9 +110,9 @@ ECS::Entity Settings::createSettings(vec2 position, vec2 scale)
 
 		RenderSystem::createSprite(resource, path, "textured");
 	}
-	ECS::registry<ShadedMeshRef>.emplace(entity, resource);
+	ECS::registry<ShadedMeshRef>().emplace(entity, resource);
 
-	auto& motion = ECS::registry<Motion>.emplace(entity);
+	auto& motion = ECS::registry<Motion>().emplace(entity);
 	motion.angle = 0.f;
 	motion.velocity = { 0.f, 0.f };
 	motion.position = position;
@@ -135,7 +135,7 @@ ECS::Entity Settings::createSettings(vec2 position, vec2 scale)
 	sound_effects_text = Text::create_text(sound_effects_str, { motion.position.x/1.75, motion.position.y - 130 }, 0.5);
 	save_text = Text::create_text("", { motion.position.x/1.37, motion.position.y + 255}, 0.5);
 
-	auto& settings = ECS::registry<Settings>.emplace(entity);
+	auto& settings = ECS::registry<Settings>().emplace(entity);
 
 	return entity;
 }
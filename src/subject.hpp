@@ -1,21 +0,0 @@
-#include "tiny_ecs.hpp"
-#include "physics.hpp"
-#include <functional>
-#include <list>
-#include <string>
-
-struct Subject
-{
-public:
-    std::list<std::function<void(ECS::Entity, ECS::Entity, Direction dir)>> observers_list;
-    static ECS::Entity createSubject(std::string name);
-    template<typename F>
-    void add_observer(F lambda)
-    {
-        observers_list.push_back(lambda);
-    }
-
-    void notify(ECS::Entity entity, ECS::Entity entity_other, Direction direction);
-};
-
-
@@ -225,7 +225,7 @@ public:
     // any fonts destroyed after main() exists still point to a valid
     // font library. Otherwise, the static font library might be destroyed
     // before other static objects that still need it (such as Font objects
-    // being used by Text objects in ECS::registry<Text>)
+    // being used by Text objects in ECS::registry<Text>())
     // See Static Initialization Order Fiasco for details:
     // https://en.cppreference.com/w/cpp/language/siof
 
@@ -540,11 +540,11 @@ ECS::Entity Text::create_text(std::string content, vec2 position, float scale)
     auto text = ECS::Entity();
     auto coolFont = Font::load("data/fonts/Cool/Cool.TTF");
 
-    ECS::registry<Text>.insert(
+    ECS::registry<Text>().insert(
         text,
         Text(content, coolFont, { position.x, position.y})
     );
-    ECS::registry<Text>.get(text).scale = scale;
+    ECS::registry<Text>().get(text).scale = scale;
     return text;
 }
 
@@ -17,13 +17,13 @@ class Font;
 
 /**
  * `Text` is a basic class used for rendering text to the screen.
- * Any `Text` object added to the ECS system via `ECS::registry<Text>`
+ * Any `Text` object added to the ECS system via `ECS::registry<Text>()`
  * will be drawn automatically on top of other visual elements.
  */
 struct Text {
     /**
      * Construct a Text object from a string, shared_ptr to a font, and a position.
-     * Text objects that are placed in `ECS::registry<Text>` will automatically
+     * Text objects that are placed in `ECS::registry<Text>()` will automatically
      * be rendered to the screen.
      *
      * `content` must be an ASCII or UTF-8 encoded Unicode string.
@@ -152,7 +152,7 @@ private:
 /**
  * Draw a Text object to the screen, given the screen buffer size.
  * NOTE: this function is called automatically by `RenderSystem::draw`
- * for all text objects in `ECS::registry<Text>` and this function is
+ * for all text objects in `ECS::registry<Text>()` and this function is
  * not to be used otherwise.
  */
 void drawText(const Text& text, glm::vec2 gameUnitSize);
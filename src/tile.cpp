@@ -20,8 +20,8 @@ ECS::Entity Tile::createTile(vec2 position, TerrainType type)
     float friction = 0.f;
 
     // Create and (empty) Tile component to be able to refer to all tiles
-    auto& tile = ECS::registry<Tile>.emplace(entity);
-    auto& motion = ECS::registry<Motion>.emplace(entity);
+    auto& tile = ECS::registry<Tile>().emplace(entity);
+    auto& motion = ECS::registry<Motion>().emplace(entity);
 
     switch (type) {
     case Water:
@@ -98,7 +98,7 @@ ECS::Entity Tile::createTile(vec2 position, TerrainType type)
         tile.terrain_type = TerrainType::Teleport;
         friction = 0.01f;
         motion.isCollidable = false;
-        ECS::registry<Teleporting>.emplace(entity);
+        ECS::registry<Teleporting>().emplace(entity);
         break;
     default:
         break;
@@ -152,7 +152,7 @@ ECS::Entity Tile::createTile(vec2 position, TerrainType type)
     }
 
     // Store a reference to the potentially re-used mesh object (the value is stored in the resource cache)
-    ECS::registry<ShadedMeshRef>.emplace(entity, resource);
+    ECS::registry<ShadedMeshRef>().emplace(entity, resource);
 
     // Reserve an entity
     auto splatEntity = ECS::Entity();
@@ -164,7 +164,7 @@ ECS::Entity Tile::createTile(vec2 position, TerrainType type)
         RenderSystem::createSprite(resource2, textures_path("splat_yellow.png"), "textured");
 
     }
-    ECS::registry<ShadedMeshRef>.emplace(splatEntity, resource2);
+    ECS::registry<ShadedMeshRef>().emplace(splatEntity, resource2);
 
     // Initialize the position, scale and physics components.
     // The only relevant component is position, as the others will not be used.
@@ -172,24 +172,24 @@ ECS::Entity Tile::createTile(vec2 position, TerrainType type)
     motion.velocity = { 0.f, 0.f };
     motion.position = position;
     motion.scale = vec2({ tileSize, tileSize });
-    motion.shape = "square";
+    motion.shape = Shape::square;
     
-    auto& terrain = ECS::registry<Terrain>.emplace(entity);
+    auto& terrain = ECS::registry<Terrain>().emplace(entity);
     terrain.type = type;
     terrain.friction = friction;
 
     tile.splatEntity = ECS::Entity();
-    ECS::registry<Motion>.emplace(tile.splatEntity);
+    ECS::registry<Motion>().emplace(tile.splatEntity);
 
     return entity;
 }
 
 void Tile::setSplat(ECS::Entity entity, blobuleCol color) {
-    if (!ECS::registry<Tile>.has(entity)) {
+    if (!ECS::registry<Tile>().has(entity)) {
         return;
     }
 
-    auto& terrain = ECS::registry<Terrain>.get(entity);
+    auto& terrain = ECS::registry<Terrain>().get(entity);
     if (terrain.type == Water || terrain.type == Block) {
         return;
     }
@@ -219,7 +219,7 @@ void Tile::setSplat(ECS::Entity entity, blobuleCol color) {
 
     colorMap[entity.id] = stringColor;
 
-    auto& tile = ECS::registry<Tile>.get(entity);
+    auto& tile = ECS::registry<Tile>().get(entity);
     ECS::Entity splatEntity = tile.splatEntity;
     ECS::ContainerInterface::remove_all_components_of(splatEntity);
 
@@ -229,16 +229,16 @@ void Tile::setSplat(ECS::Entity entity, blobuleCol color) {
 
     switch (color) {
         case blobuleCol::Blue:
-            ECS::registry<BlueSplat>.emplace(splatEntity);
+            ECS::registry<BlueSplat>().emplace(splatEntity);
             break;
         case blobuleCol::Green:
-            ECS::registry<GreenSplat>.emplace(splatEntity);
+            ECS::registry<GreenSplat>().emplace(splatEntity);
             break;
         case blobuleCol::Red:
-            ECS::registry<RedSplat>.emplace(splatEntity);
+            ECS::registry<RedSplat>().emplace(splatEntity);
             break;
         default:
-            ECS::registry<YellowSplat>.emplace(splatEntity);
+            ECS::registry<YellowSplat>().emplace(splatEntity);
             break;
     }
 
@@ -249,19 +249,34 @@ void Tile::setSplat(ECS::Entity entity, blobuleCol color) {
         RenderSystem::createSprite(resource, textures_path(key.append(".png")), "textured");
 
     }
-    ECS::registry<ShadedMeshRef>.emplace(splatEntity, resource);
+    ECS::registry<ShadedMeshRef>().emplace(splatEntity, resource);
 
-    auto& tileMotion = ECS::registry<Motion>.get(entity);
-    auto& splatMotion = ECS::registry<Motion>.emplace(splatEntity);
+    auto& tileMotion = ECS::registry<Motion>().get(entity);
+    auto& splatMotion = ECS::registry<Motion>().emplace(splatEntity);
     splatMotion.position = tileMotion.position;
     splatMotion.scale = vec2({ size * 0.6, size * 0.6 }) * static_cast<vec2>(resource.texture.size);
     splatMotion.isCollidable = false;
 }
 
+bool Tile::hasSplat(ECS::Entity entity, blobuleCol color)
+{
+    ECS::Entity splatEntity = ECS::registry<Tile>().get(entity).splatEntity;
+    switch (color) {
+        case blobuleCol::Blue:
+            return ECS::registry<BlueSplat>().has(splatEntity);
+        case blobuleCol::Green:
+            return ECS::registry<GreenSplat>().has(splatEntity);
+        case blobuleCol::Red:
+            return ECS::registry<RedSplat>().has(splatEntity);
+        default:
+            return ECS::registry<YellowSplat>().has(splatEntity);
+    }
+}
+
 void Tile::setRandomSplat(ECS::Entity entity)
 {
-    auto& tile = ECS::registry<Tile>.get(entity);
-    if (ECS::registry<BlueSplat>.has(tile.splatEntity) || ECS::registry<RedSplat>.has(tile.splatEntity) || ECS::registry<YellowSplat>.has(tile.splatEntity) || ECS::registry<GreenSplat>.has(tile.splatEntity))
+    auto& tile = ECS::registry<Tile>().get(entity);
+    if (ECS::registry<BlueSplat>().has(tile.splatEntity) || ECS::registry<RedSplat>().has(tile.splatEntity) || ECS::registry<YellowSplat>().has(tile.splatEntity) || ECS::registry<GreenSplat>().has(tile.splatEntity))
     {
         int color = 0 + (std::rand() % (3 - 0 + 1));
         std::string stringColor = "";
@@ -296,16 +311,16 @@ void Tile::setRandomSplat(ECS::Entity entity)
 
         switch (color) {
             case 0:
-                ECS::registry<BlueSplat>.emplace(splatEntity);
+                ECS::registry<BlueSplat>().emplace(splatEntity);
                 break;
             case 1:
-                ECS::registry<GreenSplat>.emplace(splatEntity);
+                ECS::registry<GreenSplat>().emplace(splatEntity);
                 break;
             case 2:
-                ECS::registry<RedSplat>.emplace(splatEntity);
+                ECS::registry<RedSplat>().emplace(splatEntity);
                 break;
             default:
-                ECS::registry<YellowSplat>.emplace(splatEntity);
+                ECS::registry<YellowSplat>().emplace(splatEntity);
                 break;
         }
 
@@ -317,12 +332,28 @@ void Tile::setRandomSplat(ECS::Entity entity)
             RenderSystem::createSprite(resource, textures_path(key.append(".png")), "textured");
 
         }
-        ECS::registry<ShadedMeshRef>.emplace(splatEntity, resource);
+        ECS::registry<ShadedMeshRef>().emplace(splatEntity, resource);
 
-        auto& tileMotion = ECS::registry<Motion>.get(entity);
-        auto& splatMotion = ECS::registry<Motion>.emplace(splatEntity);
+        auto& tileMotion = ECS::registry<Motion>().get(entity);
+        auto& splatMotion = ECS::registry<Motion>().emplace(splatEntity);
         splatMotion.position = tileMotion.position;
         splatMotion.scale = vec2({ size * 0.6, size * 0.6 }) * static_cast<vec2>(resource.texture.size);
         splatMotion.isCollidable = false;
     }
 }
+
+void ECS::Serializer<Tile>::write(ECS::SnapshotWriter& out, const Tile& tile)
+{
+    out.write(tile.splatEntity);
+    out.write(tile.gridLocation);
+    out.write(tile.terrain_type);
+}
+
+Tile ECS::Serializer<Tile>::read(ECS::SnapshotReader& in)
+{
+    Tile tile;
+    in.read(tile.splatEntity);
+    in.read(tile.gridLocation);
+    in.read(tile.terrain_type);
+    return tile;
+}
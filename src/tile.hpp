@@ -24,7 +24,7 @@ enum TerrainType {
 // tiles that form the island
 struct Tile
 {
-    ECS::Entity splatEntity;
+    ECS::Entity splatEntity = ECS::Entity::null();
     std::vector<int> gridLocation = { -1, -1 };
     TerrainType terrain_type;
 
@@ -33,9 +33,19 @@ struct Tile
 
     static void setSplat(ECS::Entity entity, blobuleCol color);
 
+    // Whether the tile already shows a splat of the given color
+    static bool hasSplat(ECS::Entity entity, blobuleCol color);
+
     static void setRandomSplat(ECS::Entity entity);
 };
 
+template <> struct ECS::Serializer<Tile>
+{
+    static constexpr bool available = true;
+    static void write(ECS::SnapshotWriter& out, const Tile& tile);
+    static Tile read(ECS::SnapshotReader& in);
+};
+
 // All data relevant to the terrain of entities
 struct Terrain {
     TerrainType type;
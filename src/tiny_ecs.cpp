@@ -5,30 +5,195 @@
 #include <iostream>
 #include <typeinfo>
 
-// We store a list of all Component containers to be able to inspect the number of components and entities in each and to remove entities across containers
+// Every world keeps a list of its Component containers to be able to inspect the number of components and entities in each and to remove entities across containers
 using namespace ECS;
 
-std::vector<ContainerInterface*>& ContainerInterface::registry_list_singleton() {
-	// This is a Meyer's singleton, i.e., a function returning a static local variable by reference to solve SIOF
-	static std::vector<ContainerInterface*> singleton; // constructed during first call
-	return singleton;
+World::World() {
+	for (auto& container : cached)
+		container.store(nullptr, std::memory_order_relaxed);
+}
+
+World::~World() {
+	// The containers take themselves out of the lists while these still exist
+	created.clear();
+	assert(containers.empty()); // Containers constructed in place of registry() must not outlive their world
+}
+
+ContainerInterface* World::create_container(unsigned int id, ContainerInterface* (*create)(World& owner)) {
+	std::lock_guard<std::mutex> lock(create_mutex);
+	ContainerInterface* container = cached[id].load(std::memory_order_relaxed);
+	if (container)
+		return container;
+	// A container constructed in place of registry(), e.g., in a test, is used as is
+	if (id < by_type.size() && by_type[id]) {
+		container = by_type[id];
+	}
+	else {
+		container = create(*this);
+		created.emplace_back(container);
+	}
+	cached[id].store(container, std::memory_order_release);
+	return container;
+}
+
+bool World::alive(Entity e) const {
+	const auto& generations = allocator.generations;
+	return e.index() != 0 && e.index() < generations.size() && generations[e.index()] == e.generation();
+}
+
+unsigned int ECS::current_frame() {
+	return World::current().frame_counter;
+}
+
+void ECS::advance_frame() {
+	World::current().frame_counter++;
+}
+
+unsigned int Entity::allocate() {
+	auto& allocator = World::current().allocator;
+	unsigned int index;
+	if (!allocator.free_indices.empty()) {
+		index = allocator.free_indices.back();
+		allocator.free_indices.pop_back();
+	}
+	else {
+		index = static_cast<unsigned int>(allocator.generations.size());
+		assert(index <= INDEX_MASK); // Ran out of entity indices
+		allocator.generations.push_back(0);
+	}
+	if (allocator.level_open) {
+		if (index >= allocator.level_owned.size())
+			allocator.level_owned.resize(index + 1, 0);
+		allocator.level_owned[index] = 1;
+		allocator.level_indices.push_back(index);
+	}
+	return index | (allocator.generations[index] << INDEX_BITS);
+}
+
+void Entity::release(Entity e) {
+	auto& allocator = World::current().allocator;
+	assert(valid(e));
+	// Note, the generation wraps around after 4096 re-uses of the same index
+	allocator.generations[e.index()] = (e.generation() + 1) & GENERATION_MASK;
+	allocator.free_indices.push_back(e.index());
+	if (e.index() < allocator.level_owned.size())
+		allocator.level_owned[e.index()] = 0;
+}
+
+bool ECS::valid(Entity e) {
+	return World::current().alive(e);
+}
+
+unsigned int ECS::next_component_type_id() {
+	// Types are first used from any thread that runs a world
+	static std::atomic<unsigned int> counter{ 0 };
+	const unsigned int id = counter++;
+	assert(id < MAX_COMPONENT_TYPES); // Raise MAX_COMPONENT_TYPES
+	return id;
+}
+
+Signature ContainerInterface::signature_of(Entity e) {
+	const World& world = World::current();
+	const auto& all = world.signatures;
+	// A stale handle has no components, its index may be in use by a newer entity
+	if (!world.alive(e) || e.index() >= all.size())
+		return Signature();
+	return all[e.index()];
+}
+
+void ContainerInterface::mark(Entity e) {
+	auto& all = world->signatures;
+	if (e.index() >= all.size())
+		all.resize(e.index() + 1);
+	all[e.index()].set(type_id);
+}
+
+void ContainerInterface::unmark(Entity e) {
+	auto& all = world->signatures;
+	// restore() may have replaced the signatures with a shorter vector from before the entity existed
+	if (e.index() < all.size())
+		all[e.index()].reset(type_id);
+}
+
+bool ContainerInterface::marked(Entity e) const {
+	const auto& all = world->signatures;
+	return world->alive(e) && e.index() < all.size() && all[e.index()].test(type_id);
+}
+
+size_t ContainerInterface::count_marked(const std::vector<unsigned char>* only_flagged) const {
+	const auto& all = world->signatures;
+	size_t count = 0;
+	for (size_t index = 0; index < all.size(); index++) {
+		if (only_flagged && (index >= only_flagged->size() || !(*only_flagged)[index]))
+			continue;
+		if (all[index].test(type_id))
+			count++;
+	}
+	return count;
+}
+
+void ContainerInterface::unmark_all() {
+	for (Signature& signature : world->signatures)
+		signature.reset(type_id);
+}
+
+std::vector<Entity> ContainerInterface::marked_entities() const {
+	const auto& all = world->signatures;
+	const auto& generations = world->allocator.generations;
+	std::vector<Entity> result;
+	for (unsigned int index = 0; index < all.size(); index++) {
+		if (all[index].test(type_id))
+			result.push_back(Entity(index | (generations[index] << Entity::INDEX_BITS)));
+	}
+	return result;
+}
+
+void ContainerInterface::attach(World* to, unsigned int id) {
+	world = to ? to : &World::current();
+	type_id = id;
+	auto& by_type = world->by_type;
+	if (id >= by_type.size())
+		by_type.resize(id + 1, nullptr);
+	assert(!by_type[id]); // One container per component type and world
+	by_type[id] = this;
+	world->containers.push_back(this);
+}
+
+void ContainerInterface::detach() {
+	auto& containers = world->containers;
+	auto it = std::find(containers.begin(), containers.end(), this);
+	assert(it != containers.end());
+	containers.erase(it);
+	world->by_type[type_id] = nullptr;
+	// registry() creates a new container should the type be used again
+	if (world->cached[type_id].load(std::memory_order_relaxed) == this)
+		world->cached[type_id].store(nullptr, std::memory_order_relaxed);
+	world = nullptr;
 }
 
 void ContainerInterface::clear_all_components() {
-	for (auto reg : registry_list_singleton()) {
+	for (auto reg : World::current().containers) {
 		reg->clear();
     }
 }
+std::vector<ContainerStats> ContainerInterface::collect_stats() {
+	std::vector<ContainerStats> result;
+	for (auto reg : World::current().containers) {
+		assert(reg); // Must not be null
+		result.push_back(reg->stats());
+	}
+	return result;
+}
 void ContainerInterface::list_all_components() {
 	std::cout << "Debug info on all registry entries:\n";
-	const auto& singleton = registry_list_singleton();
+	const auto& singleton = World::current().containers;
 	for (auto reg : singleton) {
         assert(reg); // Must not be null
 		if (reg->size() > 0) {
 			std::cout
                 << "  " << reg->size() << " components of type "
                 << typeid(*reg).name() << "\n    ";
-			for (auto entity : reg->entities) {
+			for (auto entity : reg->entities.empty() ? reg->marked_entities() : reg->entities) {
 				std::cout << entity.id << ", ";
             }
 			std::cout << '\n';
@@ -38,18 +203,183 @@ void ContainerInterface::list_all_components() {
 }
 void ContainerInterface::list_all_components_of(Entity e) {
 	std::cout << "Debug info on components of entity " << e.id << ":\n";
-	for (auto reg : registry_list_singleton()) {
-        assert(reg); // Must not be null
-		if (reg->has(e)) {
+	const Signature signature = signature_of(e);
+	const auto& by_type = World::current().by_type;
+	for (unsigned int id = 0; id < by_type.size(); id++) {
+		ContainerInterface* reg = by_type[id];
+		if (signature.test(id) && reg && reg->has(e)) {
 			std::cout
                 << "  type " << typeid(*reg).name() << ", stored at location "
-                << reg->map_entity_component_index[e.id] << '\n';
+                << reg->index_of(e) << '\n';
         }
     }
 }
 void ContainerInterface::remove_all_components_of(Entity e) {
-	for (auto reg : registry_list_singleton()) {
-        assert(reg); // Must not be null
-		reg->remove(e);
+	// Only visit the containers the entity is actually in
+	const Signature signature = signature_of(e);
+	const auto& by_type = World::current().by_type;
+	for (unsigned int id = 0; id < by_type.size(); id++) {
+		if (signature.test(id) && by_type[id])
+			by_type[id]->remove(e);
     }
 }
+void ContainerInterface::destroy_entity(Entity e) {
+	remove_all_components_of(e);
+	if (valid(e))
+		Entity::release(e);
+}
+void ContainerInterface::destroy_entities(const std::vector<Entity>& batch) {
+	std::vector<Signature> batch_signatures;
+	batch_signatures.reserve(batch.size());
+	for (Entity e : batch)
+		batch_signatures.push_back(signature_of(e));
+	for (auto reg : World::current().containers) {
+		assert(reg); // Must not be null
+		if (reg->size() == 0)
+			continue;
+		for (size_t i = 0; i < batch.size(); i++) {
+			if (batch_signatures[i].test(reg->type_id))
+				reg->remove(batch[i]);
+		}
+	}
+	for (Entity e : batch) {
+		if (valid(e))
+			Entity::release(e);
+	}
+}
+
+void CommandBuffer::flush() {
+	if (!recorded_in)
+		return;
+	World::Scope scope(*recorded_in);
+	recorded_in = nullptr;
+
+	// Group the removals per container, such that each container is touched in one go, and drop duplicates
+	std::sort(removals.begin(), removals.end(), [](const Removal& a, const Removal& b) {
+		return a.container != b.container ? a.container < b.container : a.entity.id < b.entity.id;
+	});
+	removals.erase(std::unique(removals.begin(), removals.end(), [](const Removal& a, const Removal& b) {
+		return a.container == b.container && a.entity.id == b.entity.id;
+	}), removals.end());
+	for (const Removal& removal : removals)
+		removal.container->remove(removal.entity);
+
+	std::sort(destroyed.begin(), destroyed.end(), [](Entity a, Entity b) { return a.id < b.id; });
+	destroyed.erase(std::unique(destroyed.begin(), destroyed.end(), [](Entity a, Entity b) { return a.id == b.id; }), destroyed.end());
+
+	for (auto& command : emplaces) {
+		// No point in adding components to an entity that is destroyed right after
+		if (!std::binary_search(destroyed.begin(), destroyed.end(), command->entity, [](Entity a, Entity b) { return a.id < b.id; }))
+			command->apply();
+	}
+
+	ContainerInterface::destroy_entities(destroyed);
+
+	removals.clear();
+	emplaces.clear();
+	destroyed.clear();
+
+	// Taken out first, anything a deferred change records into this buffer is applied by the next flush
+	std::vector<std::function<void()>> changes;
+	changes.swap(deferred);
+	for (auto& change : changes)
+		change();
+}
+void ContainerInterface::begin_level() {
+	auto& allocator = World::current().allocator;
+	assert(!allocator.level_open); // Levels do not nest
+	allocator.level_open = true;
+}
+void ContainerInterface::end_level() {
+	auto& allocator = World::current().allocator;
+	if (!allocator.level_open)
+		return; // e.g., on the first restart
+	for (auto reg : World::current().containers) {
+		assert(reg); // Must not be null
+		if (reg->size() > 0)
+			reg->remove_level_owned(allocator.level_owned);
+	}
+
+	// level_indices may still list entities destroyed during the level (and re-used indices twice), only release flagged ones
+	auto& all_signatures = World::current().signatures;
+	for (unsigned int index : allocator.level_indices) {
+		if (!allocator.level_owned[index])
+			continue;
+		allocator.level_owned[index] = 0;
+		allocator.generations[index] = (allocator.generations[index] + 1) & Entity::GENERATION_MASK;
+		allocator.free_indices.push_back(index);
+		if (index < all_signatures.size())
+			all_signatures[index].reset();
+	}
+	allocator.level_indices.clear();
+	allocator.level_open = false;
+}
+
+Snapshot ECS::snapshot() {
+	Snapshot result;
+	SnapshotWriter out(result.bytes);
+
+	const World& world = World::current();
+	const auto& allocator = world.allocator;
+	out.write(allocator.generations);
+	out.write(allocator.free_indices);
+	out.write(allocator.level_open);
+	out.write(allocator.level_owned);
+	out.write(allocator.level_indices);
+	std::vector<unsigned long long> signature_bits;
+	signature_bits.reserve(world.signatures.size());
+	for (const Signature& signature : world.signatures)
+		signature_bits.push_back(signature.to_ullong());
+	out.write(signature_bits);
+
+	const auto& by_type = world.by_type;
+	result.copies.resize(by_type.size());
+	out.write(by_type.size());
+	for (unsigned int id = 0; id < by_type.size(); id++) {
+		out.write(by_type[id] != nullptr);
+		if (by_type[id])
+			by_type[id]->write_snapshot(out, result.copies[id]);
+	}
+	return result;
+}
+
+void ECS::restore(const Snapshot& snapshot) {
+	SnapshotReader in(snapshot.bytes);
+	World& world = World::current();
+
+	// Only replaces the allocator after the containers, in case reading a component creates an entity handle
+	World::EntityAllocator allocator;
+	in.read(allocator.generations);
+	in.read(allocator.free_indices);
+	in.read(allocator.level_open);
+	in.read(allocator.level_owned);
+	in.read(allocator.level_indices);
+	std::vector<unsigned long long> signature_bits;
+	in.read(signature_bits);
+
+	// Component types first used after the snapshot are not in it, they are emptied while the signatures still
+	// cover the entities created since
+	const auto& by_type = world.by_type;
+	size_t stored_types;
+	in.read(stored_types);
+	for (unsigned int id = static_cast<unsigned int>(stored_types); id < by_type.size(); id++) {
+		if (by_type[id])
+			by_type[id]->clear();
+	}
+	auto& all_signatures = world.signatures;
+	all_signatures.assign(signature_bits.begin(), signature_bits.end());
+
+	for (unsigned int id = 0; id < stored_types && id < by_type.size(); id++) {
+		bool stored = false;
+		in.read(stored);
+		if (!by_type[id]) {
+			assert(!stored); // Restored into a world without the container, see restore()
+			continue;
+		}
+		if (stored)
+			by_type[id]->read_snapshot(in, snapshot.copies[id].get());
+		else
+			by_type[id]->clear(); // Its type id existed, but not its container, when the snapshot was taken
+	}
+	world.allocator = std::move(allocator);
+}
@@ -1,37 +1,409 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
 #include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <type_traits>
+#include <utility>
 
 namespace ECS {
-	// Declare the ComponentContainer upfront, such that we can define the registry and use it in the Entity class definition
+	// Declare the ComponentContainer and World upfront, such that we can declare the registry and use it in the Entity class definition
 	template <typename Component> // A template class, the Component can be any class
 	class ComponentContainer;
+	class World;
 
-	// Instanciate one component container for each desired class
-	template<class Component> // this is a variable template (c++14) that is created once per class and ECS instance https://en.cppreference.com/w/cpp/language/variable_template
-	ComponentContainer<Component> registry;
+	// The container of the component type in the current world of the calling thread, see World
+	template <typename Component>
+	ComponentContainer<Component>& registry();
 
-	// Unique identifyer for all entities
+	// Unique identifyer for all entities, ids are handed out per World
 	struct Entity
 	{
+		// Reserves a new entity in the current world, re-using the index of a destroyed entity when one is available
 		Entity()
 		{
-			id = next_id();
-			// Note, indices of already deleted entities arent re-used in this simple implementation.
+			id = allocate();
 		}
 
-		// The ID defines an entity
+		// Wraps an existing handle without reserving a new entity
+		explicit Entity(unsigned int handle) : id(handle) {}
+
+		// A handle that refers to no entity, for members that are only assigned after construction
+		static Entity null() { return Entity(0u); }
+
+		// The ID defines an entity, the low bits are the index and the high bits count how often that index was re-used
 		unsigned int id;
 
+		unsigned int index() const { return id & INDEX_MASK; }
+		unsigned int generation() const { return id >> INDEX_BITS; }
+
+		static constexpr unsigned int INDEX_BITS = 20;
+		static constexpr unsigned int INDEX_MASK = (1u << INDEX_BITS) - 1;
+		static constexpr unsigned int GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
 	private:
-		// yields ids from 1; entity 0 is the default initialization
-		static unsigned int next_id() {
-			static unsigned int id_count = 1;
-			return id_count++;
+		friend struct ContainerInterface;
+		friend bool valid(Entity e);
+
+		// yields indices from 1; index 0 is the null entity
+		static unsigned int allocate();
+		// Returns the index to the free list and bumps its generation, such that old handles to it become invalid
+		static void release(Entity e);
+	};
+
+	// True if the handle refers to an entity of the current world that has not been destroyed since
+	bool valid(Entity e);
+
+	// Frame counter of the current world used to stamp component modifications, advanced once per iteration of the game loop
+	unsigned int current_frame();
+	void advance_frame();
+
+	// Upper bound on the number of component types, one bit per type in the component signature of an entity
+	constexpr unsigned int MAX_COMPONENT_TYPES = 64;
+	using Signature = std::bitset<MAX_COMPONENT_TYPES>;
+
+	// Hands out the next free component type id, see component_type_id
+	unsigned int next_component_type_id();
+
+	// Dense id of a component type, assigned once per type on first use and shared by all worlds
+	template <typename Component>
+	unsigned int component_type_id()
+	{
+		static const unsigned int id = next_component_type_id();
+		return id;
+	}
+
+	// Paged sparse array from entity index -> array index, the sparse half of a sparse set.
+	// Lookups are two array reads instead of a hash, and pages are only allocated once an index in their range is used.
+	class SparseIndex
+	{
+	public:
+		static constexpr unsigned int INVALID = ~0u;
+
+		unsigned int find(unsigned int key) const
+		{
+			unsigned int page = key >> PAGE_BITS;
+			if (page >= pages.size() || pages[page].empty())
+				return INVALID;
+			return pages[page][key & PAGE_MASK];
 		}
+
+		void set(unsigned int key, unsigned int index)
+		{
+			unsigned int page = key >> PAGE_BITS;
+			if (page >= pages.size())
+				pages.resize(page + 1);
+			if (pages[page].empty())
+				pages[page].assign(PAGE_SIZE, INVALID);
+			pages[page][key & PAGE_MASK] = index;
+		}
+
+		void erase(unsigned int key)
+		{
+			unsigned int page = key >> PAGE_BITS;
+			if (page < pages.size() && !pages[page].empty())
+				pages[page][key & PAGE_MASK] = INVALID;
+		}
+
+		// Number of keys that have memory allocated, i.e., the allocated pages times the page size
+		size_t allocated_slots() const
+		{
+			size_t allocated_pages = 0;
+			for (const auto& page : pages)
+				allocated_pages += page.empty() ? 0 : 1;
+			return allocated_pages * PAGE_SIZE;
+		}
+
+		size_t bytes_reserved() const
+		{
+			return allocated_slots() * sizeof(unsigned int) + pages.capacity() * sizeof(pages[0]);
+		}
+
+	private:
+		static constexpr unsigned int PAGE_BITS = 10;
+		static constexpr unsigned int PAGE_SIZE = 1u << PAGE_BITS;
+		static constexpr unsigned int PAGE_MASK = PAGE_SIZE - 1;
+		std::vector<std::vector<unsigned int>> pages;
+	};
+
+	// Forward iterator for the vector-like storages below, visits owner[0] to owner[size - 1]
+	template <typename Owner, typename T>
+	class IndexIterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::remove_const_t<T>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		IndexIterator(Owner* owner, size_t position) : owner(owner), position(position) {}
+		reference operator*() const { return (*owner)[position]; }
+		pointer operator->() const { return &(*owner)[position]; }
+		IndexIterator& operator++() { ++position; return *this; }
+		IndexIterator operator++(int) { IndexIterator old = *this; ++position; return old; }
+		bool operator==(const IndexIterator& other) const { return position == other.position; }
+		bool operator!=(const IndexIterator& other) const { return position != other.position; }
+
+	private:
+		Owner* owner;
+		size_t position;
+	};
+
+	// Vector-like storage made of fixed-size blocks, growing appends a block instead of moving the existing elements.
+	// References to an element stay valid until that element is removed (remove() moves the last element into the gap).
+	template <typename T, unsigned int CHUNK_SIZE = 256>
+	class ChunkedVector
+	{
+	public:
+		ChunkedVector() = default;
+		ChunkedVector(const ChunkedVector&) = delete;
+		ChunkedVector& operator=(const ChunkedVector&) = delete;
+		ChunkedVector(ChunkedVector&& other) noexcept : chunks(std::move(other.chunks)), count(other.count) { other.count = 0; }
+		ChunkedVector& operator=(ChunkedVector&& other) noexcept
+		{
+			clear();
+			chunks = std::move(other.chunks);
+			count = other.count;
+			other.count = 0;
+			return *this;
+		}
+		~ChunkedVector() { clear(); }
+
+		using iterator = IndexIterator<ChunkedVector, T>;
+		using const_iterator = IndexIterator<const ChunkedVector, const T>;
+
+		T& operator[](size_t i) { return *slot(i); }
+		const T& operator[](size_t i) const { return *slot(i); }
+		T& back() { return *slot(count - 1); }
+		size_t size() const { return count; }
+		bool empty() const { return count == 0; }
+
+		void push_back(T&& value)
+		{
+			grow();
+			new (slot(count)) T(std::move(value));
+			count++;
+		}
+		void push_back(const T& value)
+		{
+			grow();
+			new (slot(count)) T(value);
+			count++;
+		}
+		void pop_back()
+		{
+			slot(--count)->~T();
+		}
+		// Destroys all elements, the blocks stay allocated for re-use
+		void clear()
+		{
+			while (count > 0)
+				pop_back();
+		}
+		size_t capacity() const { return chunks.size() * CHUNK_SIZE; }
+		void reserve(size_t n)
+		{
+			while (chunks.size() * CHUNK_SIZE < n)
+				chunks.push_back(std::make_unique<Chunk>());
+		}
+
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, count); }
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, count); }
+
+	private:
+		struct Chunk
+		{
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[CHUNK_SIZE];
+		};
+
+		T* slot(size_t i) const
+		{
+			return std::launder(reinterpret_cast<T*>(&chunks[i / CHUNK_SIZE]->slots[i % CHUNK_SIZE]));
+		}
+		void grow()
+		{
+			if (count == chunks.size() * CHUNK_SIZE)
+				chunks.push_back(std::make_unique<Chunk>());
+		}
+
+		std::vector<std::unique_ptr<Chunk>> chunks;
+		size_t count = 0;
+	};
+
+	// Storage for empty (tag) components, e.g., the splat colors: only counts the elements, all of them are the same object.
+	// Which entities have the tag is kept by the entity signatures alone, see ComponentContainer.
+	template <typename T>
+	class TagStorage
+	{
+		static_assert(std::is_empty<T>::value, "Only empty types carry no state");
+	public:
+		using iterator = IndexIterator<TagStorage, T>;
+		using const_iterator = IndexIterator<const TagStorage, const T>;
+
+		T& operator[](size_t) { return tag; }
+		const T& operator[](size_t) const { return tag; }
+		T& back() { return tag; }
+		size_t size() const { return count; }
+		bool empty() const { return count == 0; }
+
+		void push_back(const T&) { count++; }
+		void pop_back() { count--; }
+		void clear() { count = 0; }
+		void reserve(size_t) {}
+		size_t capacity() const { return count; }
+
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, count); }
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, count); }
+
+	private:
+		T tag;
+		size_t count = 0;
+	};
+
+	// Selects how a component type is stored, a std::vector by default and TagStorage for empty types.
+	// Specialize it next to the component to opt into stable addresses, e.g.,
+	//   template <> struct ECS::StoragePolicy<Motion> { using type = ECS::ChunkedVector<Motion>; };
+	// The specialization has to be visible wherever the registry of that component is used.
+	template <typename Component>
+	struct StoragePolicy
+	{
+		using type = std::conditional_t<std::is_empty<Component>::value, TagStorage<Component>, std::vector<Component>>;
+	};
+
+	// Appends the state of containers to the byte buffer of a Snapshot
+	class SnapshotWriter
+	{
+	public:
+		explicit SnapshotWriter(std::vector<unsigned char>& bytes) : bytes(bytes) {}
+
+		void write_bytes(const void* data, size_t size)
+		{
+			const size_t offset = bytes.size();
+			bytes.resize(offset + size);
+			if (size > 0)
+				std::memcpy(&bytes[offset], data, size);
+		}
+		template <typename T>
+		void write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Write the members of this type one by one");
+			write_bytes(&value, sizeof(T));
+		}
+		void write(const std::string& value)
+		{
+			write(value.size());
+			write_bytes(value.data(), value.size());
+		}
+		template <typename T>
+		void write(const std::vector<T>& values)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Write the elements of this vector one by one");
+			write(values.size());
+			write_bytes(values.data(), values.size() * sizeof(T));
+		}
+
+	private:
+		std::vector<unsigned char>& bytes;
+	};
+
+	// Reads back what a SnapshotWriter wrote, in the same order
+	class SnapshotReader
+	{
+	public:
+		explicit SnapshotReader(const std::vector<unsigned char>& bytes) : bytes(bytes) {}
+
+		const unsigned char* read_bytes(size_t size)
+		{
+			assert(offset + size <= bytes.size());
+			const unsigned char* data = bytes.data() + offset;
+			offset += size;
+			return data;
+		}
+		template <typename T>
+		void read(T& value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Read the members of this type one by one");
+			std::memcpy(&value, read_bytes(sizeof(T)), sizeof(T));
+		}
+		void read(std::string& value)
+		{
+			size_t size;
+			read(size);
+			value.assign(reinterpret_cast<const char*>(read_bytes(size)), size);
+		}
+		template <typename T>
+		void read(std::vector<T>& values)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Read the elements of this vector one by one");
+			size_t size;
+			read(size);
+			values.resize(size);
+			if (size > 0)
+				std::memcpy(values.data(), read_bytes(size * sizeof(T)), size * sizeof(T));
+		}
+		// Entity() reserves a new id, so the handles are built from the stored ids instead of resizing the vector
+		void read(std::vector<Entity>& values)
+		{
+			size_t size;
+			read(size);
+			const unsigned char* stored = read_bytes(size * sizeof(Entity));
+			values.clear();
+			values.reserve(size);
+			for (size_t i = 0; i < size; i++)
+			{
+				unsigned int id;
+				std::memcpy(&id, stored + i * sizeof(Entity) + offsetof(Entity, id), sizeof(id));
+				values.push_back(Entity(id));
+			}
+		}
+
+	private:
+		const std::vector<unsigned char>& bytes;
+		size_t offset = 0;
+	};
+
+	// Snapshot hook for components that are not trivially copyable (e.g., hold strings or vectors), specialize it next to the component:
+	//   template <> struct ECS::Serializer<Tile> {
+	//       static constexpr bool available = true;
+	//       static void write(ECS::SnapshotWriter& out, const Tile& tile);
+	//       static Tile read(ECS::SnapshotReader& in);
+	//   };
+	// Trivially copyable components are copied as a block and need no hook. Components with neither are copied into the snapshot as objects.
+	template <typename Component>
+	struct Serializer
+	{
+		static constexpr bool available = false;
+	};
+
+	class Snapshot;
+
+	// Memory use and activity of one component container, see ContainerInterface::collect_stats
+	struct ContainerStats
+	{
+		const char* type_name; // as reported by typeid, i.e., possibly mangled
+		size_t count; // number of components
+		size_t peak_count; // highest count since the program started
+		size_t bytes_used; // components, entities and modification stamps in use
+		size_t bytes_reserved; // allocated for them, including the sparse index
+		float index_load_factor; // used fraction of the allocated sparse index slots
+		size_t inserts_last_frame; // churn of the last completed frame
+		size_t removes_last_frame;
 	};
 
 	// Common interface to refer to all containers in the ECS registry
@@ -41,42 +413,148 @@ namespace ECS {
 		virtual size_t size() = 0;
 		virtual void remove(Entity e) = 0;
 		virtual bool has(Entity entity) = 0;
+		// Drops the components of all entities whose index is flagged in level_owned, keeping the order of the others
+		virtual void remove_level_owned(const std::vector<unsigned char>& level_owned) = 0;
+		// Appends the entities and components to out, components that can not be written as bytes are copied to a detached container in copy instead
+		virtual void write_snapshot(SnapshotWriter& out, std::unique_ptr<ContainerInterface>& copy) const = 0;
+		// Replaces the content of this container by what write_snapshot stored
+		virtual void read_snapshot(SnapshotReader& in, const ContainerInterface* copy) = 0;
+		virtual ~ContainerInterface() = default;
 
-		// The entities associated to the components in the container
+		// The entities associated to the components in the container, always empty for tags (see ComponentContainer)
 		std::vector<Entity> entities;
 
-		// Callbacks to remove a particular or all entities in the system
+		// Every entity whose signature has this component type, in index order. Walks all signatures, for tags which keep no entity list.
+		std::vector<Entity> marked_entities() const;
+
+		// Increases whenever components are added, removed or re-ordered (not when they are modified).
+		// Systems that derive data from the set of entities in a container can compare it to skip rebuilding.
+		unsigned int structure_version() const { return structure_changes; }
+
+		// Position of the entity in the entities/components arrays, SparseIndex::INVALID if it has no component here
+		unsigned int index_of(Entity e) const
+		{
+			const unsigned int array_index = entity_component_index.find(e.index());
+			// The stored handle also rejects stale handles whose index has been re-used by a newer entity
+			if (array_index == SparseIndex::INVALID || entities[array_index].id != e.id)
+				return SparseIndex::INVALID;
+			return array_index;
+		}
+
+		// The component types that entity e currently has, as a bit per component_type_id
+		static Signature signature_of(Entity e);
+
+		// Memory and churn statistics of this container
+		virtual ContainerStats stats() = 0;
+		// Statistics of all containers of the current world, in registration order
+		static std::vector<ContainerStats> collect_stats();
+
+		// Callbacks to remove a particular or all entities in the current world
 		static void clear_all_components();
 		static void list_all_components();
 		static void remove_all_components_of(Entity e);
 		static void list_all_components_of(Entity e);
+		// Removes all components of the entity and releases its id for re-use, the handle is invalid afterwards
+		static void destroy_entity(Entity e);
+		// Same as destroy_entity for many entities, but walks each container once for the whole batch
+		static void destroy_entities(const std::vector<Entity>& batch);
+
+		// Entities created after begin_level() belong to the level, end_level() destroys all of them at once.
+		// Each container is compacted in a single pass and the ids are released in bulk, no per-entity removal.
+		// end_level() without an open level does nothing.
+		static void begin_level();
+		static void end_level();
 	protected:
-		// The hash map from Entity -> array index.
-		std::unordered_map<unsigned int, unsigned int> map_entity_component_index; // the entity is cast to uint to be hashable.
-		static std::vector<ContainerInterface*>& registry_list_singleton();
+		friend class World;
+		friend Snapshot snapshot();
+		friend void restore(const Snapshot& snapshot);
+
+		// The sparse array from Entity -> array index, the entities and components vectors are the dense half.
+		SparseIndex entity_component_index;
+
+		// component_type_id of the stored type
+		unsigned int type_id = 0;
+
+		// The world whose entities this container holds components of, null for the detached containers of a Snapshot
+		World* world = nullptr;
+		// Adds the container to the world (the current one if null) as the container of component type id, and takes it out again
+		void attach(World* to, unsigned int id);
+		void detach();
+		// The frame counter of the world
+		unsigned int frame() const;
+
+		// Keep the signature of the entity in sync with this container
+		void mark(Entity e);
+		void unmark(Entity e);
+		bool marked(Entity e) const;
+		// For tags, the signatures are the whole container
+		size_t count_marked(const std::vector<unsigned char>* only_flagged = nullptr) const; // only counts indices flagged in only_flagged
+		void unmark_all();
+
+		unsigned int structure_changes = 0;
+
+		// Inserts and removes, counted per frame for stats()
+		void count_insert(size_t count)
+		{
+			roll_churn();
+			inserts_this_frame++;
+			peak_count = std::max(peak_count, count);
+		}
+		void count_remove(size_t removed = 1)
+		{
+			roll_churn();
+			removes_this_frame += removed;
+		}
+		void roll_churn()
+		{
+			const unsigned int frame = this->frame();
+			if (frame == churn_frame)
+				return;
+			// Nothing was counted in the frames in between when the last counted frame is not the previous one
+			inserts_last_frame = frame == churn_frame + 1 ? inserts_this_frame : 0;
+			removes_last_frame = frame == churn_frame + 1 ? removes_this_frame : 0;
+			inserts_this_frame = removes_this_frame = 0;
+			churn_frame = frame;
+		}
+		unsigned int churn_frame = 0;
+		size_t inserts_this_frame = 0, removes_this_frame = 0;
+		size_t inserts_last_frame = 0, removes_last_frame = 0;
+		size_t peak_count = 0;
 	};
 
-	// A container that stores components of type 'Component' and associated entities
+	// A container that stores components of type 'Component' and associated entities.
+	// Empty (tag) types store nothing but a count, an entity has the tag if the bit of the type is set in its signature.
+	// For them, entities stays empty and modification frames are not tracked, use marked_entities() to list them.
 	template <typename Component> // A component can be any class
 	class ComponentContainer : public ContainerInterface
 	{
+		static constexpr bool is_tag = std::is_empty<Component>::value;
 	public:
-		// Container of all components of type 'Component'
-		std::vector<Component> components;
+		// Container of all components of type 'Component', see StoragePolicy
+		typename StoragePolicy<Component>::type components;
 
-		// Constructor that registers the component type
+		// Constructor that registers the component type with the current world, in place of the container registry() creates
 		ComponentContainer()
 		{
-			auto& singleton = registry_list_singleton();
-			singleton.push_back(this);
+			attach(nullptr, component_type_id<Component>());
+		}
+		// The container World::registry() creates for the world
+		explicit ComponentContainer(World& owner)
+		{
+			attach(&owner, component_type_id<Component>());
 		}
-		// Destructor that frees memory from the singleton vector
+		// Tag for containers that hold the components of a Snapshot, these are not registered
+		struct Detached {};
+		explicit ComponentContainer(Detached)
+		{
+			type_id = component_type_id<Component>();
+		}
+
+		// Destructor that takes the container out of its world, which must still exist
         ~ComponentContainer()
         {
-            auto& singleton = registry_list_singleton();
-            auto it = find(begin(singleton), end(singleton), this);
-            assert(it != end(singleton));
-			singleton.erase(it);
+			if (world)
+				detach();
         }
 
 		// Disable copy operators
@@ -88,12 +566,27 @@ namespace ECS {
 		{
 			// Usually, every entity should only have one instance of each component type
 			if (check_for_duplicates)
-				assert(map_entity_component_index.find(e.id) == map_entity_component_index.end());
+				assert(!has(e));
+
+			if constexpr (is_tag)
+			{
+				if (has(e))
+					return components.back();
+				components.push_back(std::move(c));
+				mark(e);
+				structure_changes++;
+				count_insert(components.size());
+				return components.back();
+			}
 
 			auto component_index = static_cast<unsigned int>(components.size());
-			map_entity_component_index[e.id] = component_index; // Note, not using insert or emplace to allow inserting multiple components for the same entity (at your own risk)
+			entity_component_index.set(e.index(), component_index); // Note, overwrites the previous index to allow inserting multiple components for the same entity (at your own risk)
 			components.push_back(std::move(c)); // the move enforces move instead of copy constructor
 			entities.push_back(e);
+			modified_frames.push_back(frame());
+			mark(e);
+			structure_changes++;
+			count_insert(entities.size());
 			return components.back();
 		};
 
@@ -109,58 +602,294 @@ namespace ECS {
 
 		// A wrapper to return the component of an entity
 		Component& get(Entity e) {
-			const auto it = map_entity_component_index.find(e.id);
-			assert(it != map_entity_component_index.end());
-			return components[it->second]; //it->first is the key, it->second the value
+			if constexpr (is_tag)
+			{
+				assert(has(e));
+				return components.back();
+			}
+			const unsigned int component_index = index_of(e);
+			assert(component_index != SparseIndex::INVALID);
+			return components[component_index];
+		}
+
+		// Like get, but marks the component as modified in the current frame, use it for changes that changed_since should report
+		Component& patch(Entity e) {
+			static_assert(!is_tag, "Tags carry no state that could change");
+			const unsigned int component_index = index_of(e);
+			assert(component_index != SparseIndex::INVALID);
+			modified_frames[component_index] = frame();
+			return components[component_index];
+		}
+
+		// True if the component of e was inserted or patched in the given frame or later
+		bool changed_since(Entity e, unsigned int frame) const {
+			static_assert(!is_tag, "Tags carry no state that could change");
+			const unsigned int component_index = index_of(e);
+			return component_index != SparseIndex::INVALID && modified_frames[component_index] >= frame;
+		}
+
+		// Calls f(entity, component) for every component inserted or patched in the given frame or later
+		template <class Function>
+		void each_changed_since(unsigned int frame, Function f) {
+			static_assert(!is_tag, "Tags carry no state that could change");
+			for (unsigned int i = 0; i < components.size(); i++)
+				if (modified_frames[i] >= frame)
+					f(entities[i], components[i]);
 		}
 
 		// Check if entity has a component of type 'Component'
 		bool has(Entity e) override  {
-			return map_entity_component_index.find(e.id) != map_entity_component_index.end();
+			// Tags have nothing to look up, the bit in the entity's signature suffices
+			if constexpr (is_tag)
+				return marked(e);
+			else
+				return index_of(e) != SparseIndex::INVALID;
 		}
 
 		// Remove an component and pack the container to re-use the empty space
 		void remove(Entity e) override
 		{
+			if constexpr (is_tag)
+			{
+				if (!has(e))
+					return;
+				unmark(e);
+				components.pop_back();
+				structure_changes++;
+				count_remove();
+				return;
+			}
+
 			// Get the current position
-			const auto it = map_entity_component_index.find(e.id);
-			if (it == map_entity_component_index.end())
+			const unsigned int array_index = index_of(e);
+			if (array_index == SparseIndex::INVALID)
 				return; // no component stored for this element, nothing to do
 
-			int array_index = it->second;
 			// Move the last element to position cID using the move operator
 			// Note, components[cID] = components.back() would trigger the copy instead of move operator
 			components[array_index] = std::move(components.back());
 			entities[array_index] = entities.back(); // the entity is only a single index, copy it.
-			map_entity_component_index[entities.back().id] = array_index;
+			modified_frames[array_index] = modified_frames.back();
+			entity_component_index.set(entities.back().index(), array_index);
 
 			// Erase the old component and free its memory
-			map_entity_component_index.erase(it);
+			entity_component_index.erase(e.index());
+			unmark(e);
 			components.pop_back();
 			entities.pop_back();
+			modified_frames.pop_back();
+			structure_changes++;
+			count_remove();
 		};
 
-		// Sort the components and associated entity assignment structures by the comparisonFunction that compares the order of two entities, see std::sort
+		void write_snapshot(SnapshotWriter& out, std::unique_ptr<ContainerInterface>& copy) const override
+		{
+			// The signatures are all there is to a tag, restore() writes them as a whole
+			if constexpr (is_tag)
+				return;
+			out.write(entities);
+			if constexpr (std::is_trivially_copyable<Component>::value)
+			{
+				if constexpr (std::is_same<decltype(components), std::vector<Component>>::value)
+					out.write_bytes(components.data(), components.size() * sizeof(Component));
+				else
+					for (const Component& component : components)
+						out.write_bytes(&component, sizeof(Component));
+			}
+			else if constexpr (Serializer<Component>::available)
+			{
+				for (const Component& component : components)
+					Serializer<Component>::write(out, component);
+			}
+			else
+			{
+				auto detached = std::make_unique<ComponentContainer>(Detached{});
+				for (const Component& component : components)
+					detached->components.push_back(component);
+				copy = std::move(detached);
+			}
+		}
+
+		void read_snapshot(SnapshotReader& in, const ContainerInterface* copy) override
+		{
+			components.clear();
+			structure_changes++;
+			if constexpr (is_tag)
+			{
+				// restore() has put back the signatures already
+				for (size_t i = count_marked(); i > 0; i--)
+					components.push_back(Component());
+				return;
+			}
+
+			for (Entity e : entities)
+				entity_component_index.erase(e.index());
+			in.read(entities);
+			const unsigned int count = static_cast<unsigned int>(entities.size());
+			if constexpr (std::is_trivially_copyable<Component>::value)
+			{
+				// The bytes need not be aligned for Component, and components need not be default constructible,
+				// so each is copied into aligned storage first
+				const unsigned char* stored = in.read_bytes(count * sizeof(Component));
+				components.reserve(count);
+				alignas(Component) unsigned char slot[sizeof(Component)];
+				for (unsigned int i = 0; i < count; i++)
+				{
+					std::memcpy(slot, stored + i * sizeof(Component), sizeof(Component));
+					components.push_back(*std::launder(reinterpret_cast<Component*>(slot)));
+				}
+			}
+			else if constexpr (Serializer<Component>::available)
+			{
+				for (unsigned int i = 0; i < count; i++)
+					components.push_back(Serializer<Component>::read(in));
+			}
+			else
+			{
+				assert(copy);
+				for (const Component& component : static_cast<const ComponentContainer*>(copy)->components)
+					components.push_back(component);
+			}
+			for (unsigned int i = 0; i < count; i++)
+				entity_component_index.set(entities[i].index(), i);
+			// The signatures are restored as a whole by restore()
+			modified_frames.assign(count, frame());
+		}
+
+		void remove_level_owned(const std::vector<unsigned char>& level_owned) override
+		{
+			if constexpr (is_tag)
+			{
+				// The signatures are reset by end_level together with the ids
+				const size_t removed = count_marked(&level_owned);
+				if (removed == 0)
+					return;
+				count_remove(removed);
+				for (size_t i = 0; i < removed; i++)
+					components.pop_back();
+				structure_changes++;
+				return;
+			}
+
+			unsigned int kept = 0;
+			for (unsigned int i = 0; i < entities.size(); i++)
+			{
+				const Entity e = entities[i];
+				if (e.index() < level_owned.size() && level_owned[e.index()])
+				{
+					// The signature is reset by end_level together with the id
+					entity_component_index.erase(e.index());
+					continue;
+				}
+				if (kept != i)
+				{
+					components[kept] = std::move(components[i]);
+					entities[kept] = e;
+					modified_frames[kept] = modified_frames[i];
+					entity_component_index.set(e.index(), kept);
+				}
+				kept++;
+			}
+			if (kept == entities.size())
+				return;
+			count_remove(entities.size() - kept);
+			// The capacity is kept, the next level is built into the same memory
+			while (components.size() > kept)
+				components.pop_back();
+			entities.erase(entities.begin() + kept, entities.end());
+			modified_frames.erase(modified_frames.begin() + kept, modified_frames.end());
+			structure_changes++;
+		}
+
+		// Sort the components and associated entity assignment structures by the comparisonFunction that compares the order of two entities, see std::sort.
+		// Entities that compare equal keep their relative order. Sorts in place and only allocates when the container grew since the last sort.
 		template <class Compare>
 		void sort(Compare comparisonFunction)
 		{
-			// First sort the entity list as desired
-			std::sort(entities.begin(), entities.end(), comparisonFunction);
-			// Now re-arrange the components (Note, creates a temporary vector, which may be slow! Not sure if in-place could be faster: https://stackoverflow.com/questions/63703637/how-to-efficiently-permute-an-array-in-place-using-stdswap)
-			std::vector<Component> components_new; components_new.reserve(components.size());
-			std::transform(entities.begin(), entities.end(), std::back_inserter(components_new), [&](Entity e) { return std::move(get(e)); }); // note, the get still uses the old hash map (on purpose!)
-			components = std::move(components_new); // Note, we use move operations to not create unneccesary copies of objects, but memory is still allocated for the new vector
-			// Fill the new hashmap
-			for (unsigned int i = 0; i < entities.size(); i++)
-				map_entity_component_index[entities[i].id] = i;
+			static_assert(!is_tag, "Tags are not stored in an order");
+			// Sort a permutation rather than the entities themselves, such that comparisonFunction can still use get() on this container
+			sort_order.resize(entities.size());
+			for (unsigned int i = 0; i < sort_order.size(); i++)
+				sort_order[i] = i;
+			std::sort(sort_order.begin(), sort_order.end(), [&](unsigned int a, unsigned int b) {
+				if (comparisonFunction(entities[a], entities[b]))
+					return true;
+				return !comparisonFunction(entities[b], entities[a]) && a < b;
+			});
+
+			// Apply the permutation by following its cycles, position i receives the element stored at sort_order[i].
+			// Every element is moved once and only the sparse slots of moved elements are rewritten.
+			bool moved = false;
+			for (unsigned int start = 0; start < sort_order.size(); start++)
+			{
+				if (sort_order[start] == start)
+					continue;
+				Component component = std::move(components[start]);
+				const Entity entity = entities[start];
+				const unsigned int modified_frame = modified_frames[start];
+				unsigned int hole = start;
+				while (sort_order[hole] != start)
+				{
+					const unsigned int source = sort_order[hole];
+					components[hole] = std::move(components[source]);
+					entities[hole] = entities[source];
+					modified_frames[hole] = modified_frames[source];
+					entity_component_index.set(entities[hole].index(), hole);
+					sort_order[hole] = hole; // placed
+					hole = source;
+				}
+				components[hole] = std::move(component);
+				entities[hole] = entity;
+				modified_frames[hole] = modified_frame;
+				entity_component_index.set(entity.index(), hole);
+				sort_order[hole] = hole;
+				moved = true;
+			}
+			if (moved)
+				structure_changes++;
 		}
 
 		// Remove all components of type 'Component'
 		void clear() override
 		{
-			map_entity_component_index.clear();
+			count_remove(components.size());
+			if constexpr (is_tag)
+			{
+				unmark_all();
+				components.clear();
+				structure_changes++;
+				return;
+			}
+			// Only reset the slots in use, the pages stay allocated for the next level
+			for (Entity e : entities)
+			{
+				entity_component_index.erase(e.index());
+				unmark(e);
+			}
 			components.clear();
 			entities.clear();
+			modified_frames.clear();
+			structure_changes++;
+		}
+
+		ContainerStats stats() override
+		{
+			roll_churn();
+			ContainerStats result;
+			result.type_name = typeid(Component).name();
+			result.count = components.size();
+			result.peak_count = peak_count;
+			// Tags only take their bit in the signatures
+			const size_t component_bytes = is_tag ? 0 : sizeof(Component);
+			const size_t bytes_per_entry = is_tag ? 0 : component_bytes + sizeof(Entity) + sizeof(unsigned int);
+			result.bytes_used = components.size() * bytes_per_entry;
+			result.bytes_reserved = components.capacity() * component_bytes + entities.capacity() * sizeof(Entity) +
+				modified_frames.capacity() * sizeof(unsigned int) + entity_component_index.bytes_reserved();
+			const size_t slots = entity_component_index.allocated_slots();
+			result.index_load_factor = slots == 0 ? 0.f : static_cast<float>(components.size()) / static_cast<float>(slots);
+			result.inserts_last_frame = inserts_last_frame;
+			result.removes_last_frame = removes_last_frame;
+			return result;
 		}
 
 		// Report the number of components of type 'Component'
@@ -168,5 +897,331 @@ namespace ECS {
 		{
 			return components.size();
 		}
+
+	private:
+		// frame() at the last insert or patch of each component, parallel to components
+		std::vector<unsigned int> modified_frames;
+		// Scratch permutation of sort(), kept to not allocate on every sort
+		std::vector<unsigned int> sort_order;
 	};
+
+	// All entities and components of one simulation: a container per component type, the entity allocator and the signatures.
+	// registry(), Entity(), view() and the static ContainerInterface functions work on the current world of the calling thread,
+	// which is World::main() unless a World::Scope made another one current. Worlds share nothing, such that separate threads
+	// can each run a simulation of their own, e.g., a headless game or a benchmark next to the game.
+	// Jobs of the JobSystem run in the world of the thread that submitted them.
+	class World
+	{
+	public:
+		World();
+		~World();
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+
+		// The world of the game, current on every thread that did not make another one current
+		static World& main()
+		{
+			// Meyer's singleton, entities are created during static initialization (e.g., global handles)
+			static World world;
+			return world;
+		}
+		static World& current()
+		{
+			return current_world ? *current_world : main();
+		}
+
+		// Makes the world current on this thread until the scope ends, scopes nest
+		class Scope
+		{
+		public:
+			explicit Scope(World& world) : previous(current_world) { current_world = &world; }
+			~Scope() { current_world = previous; }
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		private:
+			World* previous;
+		};
+
+		// The container of the component type in this world, created on first use
+		template <typename Component>
+		ComponentContainer<Component>& registry()
+		{
+			ContainerInterface* container = cached[component_type_id<Component>()].load(std::memory_order_acquire);
+			if (!container)
+				container = create_container(component_type_id<Component>(), [](World& owner) -> ContainerInterface* {
+					return new ComponentContainer<Component>(owner);
+				});
+			return static_cast<ComponentContainer<Component>&>(*container);
+		}
+
+	private:
+		friend struct Entity;
+		friend struct ContainerInterface;
+		friend bool valid(Entity e);
+		friend unsigned int current_frame();
+		friend void advance_frame();
+		friend Snapshot snapshot();
+		friend void restore(const Snapshot& snapshot);
+
+		// Generation of every entity index handed out so far, and the indices of destroyed entities that can be re-used
+		struct EntityAllocator
+		{
+			std::vector<unsigned int> generations = { 0 }; // index 0 is reserved for the null entity
+			std::vector<unsigned int> free_indices;
+			// Indices allocated while a level is open, flagged in level_owned until they are released
+			bool level_open = false;
+			std::vector<unsigned char> level_owned;
+			std::vector<unsigned int> level_indices;
+		};
+
+		// Same as ECS::valid for this world
+		bool alive(Entity e) const;
+		// Creates the container of component type id once, registry() calls it when several threads may ask at the same time
+		ContainerInterface* create_container(unsigned int id, ContainerInterface* (*create)(World& owner));
+
+		static inline thread_local World* current_world = nullptr;
+
+		EntityAllocator allocator;
+		// Component signature of every entity index, the bits are cleared together with the components
+		std::vector<Signature> signatures;
+		unsigned int frame_counter = 0;
+
+		// All containers of this world in registration order, and by component_type_id
+		std::vector<ContainerInterface*> containers;
+		std::vector<ContainerInterface*> by_type;
+		// What registry() returns by component_type_id, set once under create_mutex such that registry() reads it without a lock
+		std::atomic<ContainerInterface*> cached[MAX_COMPONENT_TYPES];
+		std::mutex create_mutex;
+		// The containers registry() created, owned by the world
+		std::vector<std::unique_ptr<ContainerInterface>> created;
+	};
+
+	template <typename Component>
+	ComponentContainer<Component>& registry()
+	{
+		return World::current().registry<Component>();
+	}
+
+	inline unsigned int ContainerInterface::frame() const
+	{
+		return world ? world->frame_counter : 0;
+	}
+
+	// The complete state of a world (all entities, components and entity ids) captured by ECS::snapshot().
+	// Trivially copyable components are stored as one block per container in a single contiguous buffer.
+	class Snapshot
+	{
+	public:
+		Snapshot() = default;
+		Snapshot(Snapshot&&) = default;
+		Snapshot& operator=(Snapshot&&) = default;
+
+		size_t size_in_bytes() const { return bytes.size(); }
+
+	private:
+		friend Snapshot snapshot();
+		friend void restore(const Snapshot& snapshot);
+
+		std::vector<unsigned char> bytes;
+		// Containers of components without a byte representation, by component_type_id
+		std::vector<std::unique_ptr<ContainerInterface>> copies;
+	};
+
+	// Captures all entities and components of the current world, e.g., for save states or to simulate a shot and roll it back
+	Snapshot snapshot();
+	// Makes the current world exactly what it was when the snapshot was taken, the same snapshot can be restored several times.
+	// Restore into the world the snapshot was taken of, or one that has the containers of all component types stored in it.
+	// Entities created after the snapshot lose their components, and their ids are handed out again in the same order.
+	void restore(const Snapshot& snapshot);
+
+	// Records structural changes (create/emplace/remove/destroy) during a system pass and applies them in one batch on flush().
+	// Containers can be iterated while recording, e.g., removing the component that is currently visited:
+	//   ECS::CommandBuffer commands;
+	//   for (auto& entity : ECS::registry<Powerup>().entities) commands.remove<Powerup>(entity);
+	//   commands.flush();
+	// On flush, removals are applied first (grouped per container), then emplaces in recording order, then destroys, then deferred calls.
+	// Recording is not synchronized, systems that may run at the same time record into buffers of their own.
+	// The commands apply to the world they were recorded in, all commands of one batch come from the same world.
+	class CommandBuffer
+	{
+	public:
+		CommandBuffer() = default;
+		CommandBuffer(const CommandBuffer&) = delete;
+		CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+		// The id is reserved immediately, such that components can be recorded for it, the components are only added on flush.
+		// Reserving it changes the entity allocator, use defer() in systems that run alongside others.
+		Entity create()
+		{
+			record();
+			return Entity();
+		}
+
+		// Constructs the component now and inserts it on flush, unless the entity is destroyed in the same batch
+		template <typename Component, typename... Args>
+		void emplace(Entity e, Args&&... args)
+		{
+			record();
+			emplaces.push_back(std::make_unique<EmplaceCommand<Component>>(e, Component(std::forward<Args>(args)...)));
+		}
+
+		template <typename Component>
+		void remove(Entity e)
+		{
+			record();
+			removals.push_back({ &registry<Component>(), e });
+		}
+
+		// Removes all components of the entity and releases its id on flush, recording the same entity twice is fine
+		void destroy(Entity e)
+		{
+			record();
+			destroyed.push_back(e);
+		}
+
+		// True if destroy(e) was recorded since the last flush, for skipping entities that are already on their way out
+		bool is_destroyed(Entity e) const
+		{
+			return std::find_if(destroyed.begin(), destroyed.end(), [e](Entity d) { return d.id == e.id; }) != destroyed.end();
+		}
+
+		// Calls change on flush, for changes made by functions that build whole entities, e.g., Egg::createEgg
+		void defer(std::function<void()> change)
+		{
+			record();
+			deferred.push_back(std::move(change));
+		}
+
+		bool empty() const
+		{
+			return removals.empty() && emplaces.empty() && destroyed.empty() && deferred.empty();
+		}
+
+		// Applies and forgets all recorded commands
+		void flush();
+
+	private:
+		void record()
+		{
+			World& current = World::current();
+			assert(!recorded_in || recorded_in == &current); // Flush before recording for another world
+			recorded_in = &current;
+		}
+
+		struct Command
+		{
+			virtual ~Command() = default;
+			virtual void apply() = 0;
+			Entity entity = Entity::null();
+		};
+
+		template <typename Component>
+		struct EmplaceCommand : Command
+		{
+			EmplaceCommand(Entity e, Component c) : component(std::move(c)) { entity = e; }
+			void apply() override { registry<Component>().insert(entity, std::move(component)); }
+			Component component;
+		};
+
+		struct Removal
+		{
+			ContainerInterface* container;
+			Entity entity;
+		};
+
+		std::vector<Removal> removals;
+		std::vector<std::unique_ptr<Command>> emplaces;
+		std::vector<Entity> destroyed;
+		std::vector<std::function<void()>> deferred;
+		// The world of the recorded commands, null while nothing is recorded
+		World* recorded_in = nullptr;
+	};
+
+	// A join over several component types that visits every entity having all of them.
+	// Iteration is driven by the smallest container and the array index of each component is looked up once per entity, e.g.,
+	//   for (auto [entity, motion, blob] : ECS::view<Motion, Blobule>()) { ... }
+	// Tags keep no entity list, they only filter by signature and never drive the iteration.
+	// Note, like iterating the containers directly, adding or removing components of the viewed types invalidates the view.
+	template <typename... Components>
+	class View
+	{
+		static_assert((!std::is_empty<Components>::value || ...), "A view needs a component that is not a tag, use marked_entities() for tags alone");
+	public:
+		View() : containers(&registry<Components>()...)
+		{
+			driver = nullptr;
+			const bool is_tag[] = { std::is_empty<Components>::value... };
+			ContainerInterface* candidates[] = { &registry<Components>()... };
+			for (size_t i = 0; i < sizeof...(Components); i++)
+				if (!is_tag[i] && (!driver || candidates[i]->size() < driver->size()))
+					driver = candidates[i];
+		}
+
+		class iterator
+		{
+		public:
+			iterator(View* view, size_t position) : view(view), position(position) { skip_unmatched(); }
+
+			std::tuple<Entity, Components&...> operator*() const
+			{
+				return deref(std::index_sequence_for<Components...>{});
+			}
+			iterator& operator++()
+			{
+				++position;
+				skip_unmatched();
+				return *this;
+			}
+			bool operator!=(const iterator& other) const { return position != other.position; }
+
+		private:
+			// Advance to the next entity of the driving container that has all components, remembering where they are stored
+			void skip_unmatched()
+			{
+				while (position < view->driver->entities.size() && !fetch(std::index_sequence_for<Components...>{}))
+					++position;
+			}
+			template <size_t... I>
+			bool fetch(std::index_sequence<I...>)
+			{
+				Entity e = view->driver->entities[position];
+				return (locate(indices[I], std::get<I>(view->containers), e) && ...);
+			}
+			template <typename Component>
+			bool locate(unsigned int& index, ComponentContainer<Component>* container, Entity e) const
+			{
+				if constexpr (std::is_empty<Component>::value)
+				{
+					index = 0; // all elements of a tag are the same
+					return container->has(e);
+				}
+				// The driving container is walked in order, no need to look the entity up there
+				index = container == view->driver ? static_cast<unsigned int>(position) : container->index_of(e);
+				return index != SparseIndex::INVALID;
+			}
+			template <size_t... I>
+			std::tuple<Entity, Components&...> deref(std::index_sequence<I...>) const
+			{
+				return { view->driver->entities[position], std::get<I>(view->containers)->components[indices[I]]... };
+			}
+
+			View* view;
+			size_t position;
+			unsigned int indices[sizeof...(Components)];
+		};
+
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, driver->entities.size()); }
+
+	private:
+		std::tuple<ComponentContainer<Components>*...> containers;
+		ContainerInterface* driver;
+	};
+
+	// Convenience function to create a view over the registry containers of the given component types
+	template <typename... Components>
+	View<Components...> view()
+	{
+		return View<Components...>();
+	}
 }
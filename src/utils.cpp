@@ -6,13 +6,17 @@
 #include "utils.hpp"
 #include "tile.hpp"
 #include "egg.hpp"
+#include "jobs.hpp"
 #include <render_components.hpp>
 
+// Tiles per parallel_for job when the camera moves
+const size_t TILE_CHUNK_SIZE = 128;
+
 ECS::Entity& Utils::getActivePlayerBlobule()
 {
-	for (ECS::Entity& blobule : ECS::registry<Blobule>.entities)
+	for (ECS::Entity& blobule : ECS::registry<Blobule>().entities)
 	{
-		if (ECS::registry<Blobule>.get(blobule).active_player)
+		if (ECS::registry<Blobule>().get(blobule).active_player)
 		{
 			return blobule;
 		}
@@ -21,27 +25,43 @@ ECS::Entity& Utils::getActivePlayerBlobule()
 }
 void Utils::moveCamera(float xOffset, float yOffset) {
 	// Move all Blobules
-	for (auto& blob : ECS::registry<Blobule>.entities)
+	for (auto [entity, motion, blob] : ECS::view<Motion, Blobule>())
 	{
-		ECS::registry<Motion>.get(blob).position += vec2({ xOffset, yOffset });
-		ECS::registry<Blobule>.get(blob).origin += vec2({ xOffset, yOffset });
+		motion.position += vec2({ xOffset, yOffset });
+		blob.origin += vec2({ xOffset, yOffset });
 	}
 	// Move all tiles
-	for (auto& tile : ECS::registry<Tile>.entities)
+	// Every tile only touches its own and its splat's Motion, so the tiles are split across threads
+	auto& motion_container = ECS::registry<Motion>();
+	JobSystem::instance().parallel_for(ECS::registry<Tile>(), TILE_CHUNK_SIZE, [&](ECS::Entity entity, Tile& tileComponent) {
+		if (!motion_container.has(entity))
+			return;
+		motion_container.get(entity).position += vec2({ xOffset, yOffset });
+		motion_container.get(tileComponent.splatEntity).position += vec2({ xOffset, yOffset });
+	});
+	// Move all eggs
+	for (auto [entity, motion, egg] : ECS::view<Motion, Egg>())
 	{
-		auto& tileComponent = ECS::registry<Tile>.get(tile);
-		ECS::registry<Motion>.get(tile).position += vec2({ xOffset, yOffset });
-		ECS::registry<Motion>.get(tileComponent.splatEntity).position += vec2({ xOffset, yOffset });
+		motion.position += vec2({ xOffset, yOffset });
 	}
-	// Move all eggs
-	for (auto& egg : ECS::registry<Egg>.entities)
+	// Keep rendering the bodies from where they were, relative to the moved camera
+	for (auto& body : ECS::registry<RigidBody>().components)
 	{
-		ECS::registry<Motion>.get(egg).position += vec2({ xOffset, yOffset });
+		body.previous_position += vec2({ xOffset, yOffset });
 	}
 
-	for (auto& debuglines : ECS::registry<DebugComponent>.entities)
+	for (auto [entity, motion, debugComponent] : ECS::view<Motion, DebugComponent>())
+	{
+		motion.position += vec2({ xOffset, yOffset });
+	}
+}
+
+void Utils::placeBody(ECS::Entity entity, vec2 position)
+{
+	ECS::registry<Motion>().get(entity).position = position;
+	if (ECS::registry<RigidBody>().has(entity))
 	{
-		ECS::registry<Motion>.get(debuglines).position += vec2({ xOffset, yOffset });
+		ECS::registry<RigidBody>().get(entity).previous_position = position;
 	}
 }
 
@@ -96,4 +116,61 @@ float Utils::getDist(vec2 lineStart, vec2 lineEnd)
 vec2 Utils::getPerpendicularPoint(vec2 center, vec2 lineStart, vec2 lineEnd) {
 	float k = ((lineEnd.y - lineStart.y) * (center.x - lineStart.x) - (lineEnd.x - lineStart.x) * (center.y - lineStart.y)) / ((lineEnd.y - lineStart.y) * (lineEnd.y - lineStart.y) + (lineEnd.x - lineStart.x) * (lineEnd.x - lineStart.x));
 	return vec2{ center.x - k * (lineEnd.y - lineStart.y), center.y + k * (lineEnd.x - lineStart.x) };
-}
\ No newline at end of file
+}
+
+bool Utils::sweepCircleAabb(vec2 start, vec2 end, float radius, vec2 boxMin, vec2 boxMax, float& toi)
+{
+    // Already touching at the start
+    vec2 closest = glm::clamp(start, boxMin, boxMax);
+    if (dot(start - closest, start - closest) <= radius * radius)
+    {
+        toi = 0.f;
+        return true;
+    }
+
+    // The circle center touches the box exactly when it is inside the box grown by the radius with rounded corners.
+    // Clip the movement against the grown box first.
+    vec2 movement = end - start;
+    float enter = 0.f;
+    float exit = 1.f;
+    for (int axis = 0; axis < 2; axis++)
+    {
+        float low = boxMin[axis] - radius;
+        float high = boxMax[axis] + radius;
+        if (movement[axis] == 0.f)
+        {
+            if (start[axis] < low || start[axis] > high)
+                return false;
+            continue;
+        }
+        float t1 = (low - start[axis]) / movement[axis];
+        float t2 = (high - start[axis]) / movement[axis];
+        enter = max(enter, min(t1, t2));
+        exit = min(exit, max(t1, t2));
+        if (enter > exit)
+            return false;
+    }
+
+    // Entering next to a face is a hit, entering in a corner square only if the center also reaches the rounded corner
+    vec2 hit = start + enter * movement;
+    bool outsideX = hit.x < boxMin.x || hit.x > boxMax.x;
+    bool outsideY = hit.y < boxMin.y || hit.y > boxMax.y;
+    if (!outsideX || !outsideY)
+    {
+        toi = enter;
+        return true;
+    }
+    vec2 corner = { hit.x < boxMin.x ? boxMin.x : boxMax.x, hit.y < boxMin.y ? boxMin.y : boxMax.y };
+    vec2 offset = start - corner;
+    float a = dot(movement, movement);
+    float b = dot(offset, movement);
+    float c = dot(offset, offset) - radius * radius;
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.f)
+        return false;
+    float t = (-b - sqrt(discriminant)) / a;
+    if (t < 0.f || t > 1.f)
+        return false;
+    toi = t;
+    return true;
+}
@@ -11,6 +11,9 @@ struct Utils
 
     static void moveCamera(float xOffset, float yOffset);
 
+    // Puts the entity at position, rigid bodies are drawn there right away instead of interpolating across the jump
+    static void placeBody(ECS::Entity entity, vec2 position);
+
     // Get Euclidean distance between two motions
     static float euclideanDist(Motion motion1, Motion motion2);
 
@@ -24,5 +27,8 @@ struct Utils
 
     static vec2 getPerpendicularPoint(vec2 center, vec2 lineStart, vec2 lineEnd);
 
+    // Swept circle vs axis-aligned box: if a circle moving from start to end touches the box, toi is the fraction of the way (0 to 1) at which it first does
+    static bool sweepCircleAabb(vec2 start, vec2 end, float radius, vec2 boxMin, vec2 boxMax, float& toi);
+
 };
 
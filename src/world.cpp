@@ -44,7 +44,6 @@ std::vector<std::vector<ECS::Entity>> islandGrid;
 
 // Movement speed of blobule.
 float moveSpeed = 200.f;
-float terminalVelocity = 20.f;
 float max_blobule_speed = 250.f;
 float max_blue_speed = 161.f;
 vec2 window_size;
@@ -84,9 +83,8 @@ cv::VideoCapture cap;
 //}
 
 bool noBlobulesMoving() {
-    for (ECS::Entity entity : ECS::registry<Blobule>.entities)
+    for (auto [entity, motion, blob] : ECS::view<Motion, Blobule>())
     {
-        Motion& motion = ECS::registry<Motion>.get(entity);
         if (motion.velocity.x != 0 || motion.velocity.y != 0)
         {
             return false;
@@ -95,8 +93,14 @@ bool noBlobulesMoving() {
     return true;
 }
 
+// Text entities only have a Text component, destroy them rather than clearing the container so their ids are re-used
+void destroyAllText() {
+    while (ECS::registry<Text>().entities.size() > 0)
+        ECS::ContainerInterface::destroy_entity(ECS::registry<Text>().entities.back());
+}
+
 // Note, this has a lot of OpenGL specific things, could be moved to the renderer; but it also defines the callbacks to the mouse and keyboard. That is why it is called here.
-WorldSystem::WorldSystem(ivec2 window_size_px)
+WorldSystem::WorldSystem(ivec2 window_size_px, ECS::World& world) : world(world)
 {
     gameState = GameState::Start;
 	window_size = window_size_px;
@@ -160,6 +164,7 @@ WorldSystem::~WorldSystem() {
 		Mix_FreeChunk(game_start_sound);
 
 	// Destroy all created components
+	ECS::World::Scope scope(world);
 	ECS::ContainerInterface::clear_all_components();
 
 	// Close the window
@@ -190,23 +195,29 @@ void WorldSystem::init_audio()
 			audio_path("game_start.wav"));
 }
 
-// Update our game world
-void WorldSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
+// Restarts between simulation steps, such that no system sees the level while it is rebuilt
+void WorldSystem::restart_if_requested()
 {
-    (void)elapsed_ms; // silence unused warning
-    (void)window_size_in_game_units; // silence unused warning
-
+    ECS::World::Scope scope(world);
     if (should_restart_game) {
         if (should_go_to_main_menu) {
             gameState = GameState::Start;
         }
         restart();
     }
+}
+
+// Update our game world
+void WorldSystem::step(float elapsed_ms, vec2 window_size_in_game_units, ECS::CommandBuffer& commands)
+{
+    ECS::World::Scope scope(world);
+    (void)elapsed_ms; // silence unused warning
+    (void)window_size_in_game_units; // silence unused warning
 
     if (gameState == GameState::Game) {
         std::string active_colour = "";
-        if (ECS::registry<Blobule>.has(active_player)) {
-            active_colour = ECS::registry<Blobule>.get(active_player).color;
+        if (ECS::registry<Blobule>().has(active_player)) {
+            active_colour = ECS::registry<Blobule>().get(active_player).color;
             active_colour[0] = toupper(active_colour[0]);
         }
 
@@ -215,73 +226,83 @@ void WorldSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
         title_ss << "Welcome to Tile Island!";
         glfwSetWindowTitle(window, title_ss.str().c_str());
 
-        // Updating Score UI
-        std::stringstream scores;
-        std::stringstream current_player;
-
-        // Switch Player Statement
-        std::string end_turn_message = "Press Enter to End Your Turn";
-        std::string winner_colour = "Blue";
+        if (ECS::registry<Egg>().components.size() < MAX_EGGS && next_egg_spawn == 0)
+        {
+            next_egg_spawn = 3;
+            // Hatches in the middle of the island wherever the camera moved it by then
+            commands.defer([]() {
+                auto& motion = ECS::registry<Motion>().get(islandGrid[numWidth / 2][numHeight / 2]);
+                Egg::createEgg(motion.position);
+            });
+        }
 
-        if (current_turn == MAX_TURNS)
+        // Updating Score UI, only when a splat count, the turn, the active player or the text entities changed
+        const unsigned long long score_version =
+            static_cast<unsigned long long>(ECS::registry<YellowSplat>().structure_version()) + ECS::registry<GreenSplat>().structure_version() +
+            ECS::registry<RedSplat>().structure_version() + ECS::registry<BlueSplat>().structure_version() + ECS::registry<Text>().structure_version();
+        if (score_version != score_text_version || current_turn != score_text_turn || active_player.id != score_text_player.id)
         {
-            if (ECS::registry<YellowSplat>.entities.size() >= ECS::registry<GreenSplat>.entities.size() && ECS::registry<YellowSplat>.entities.size() >= ECS::registry<RedSplat>.entities.size() && ECS::registry<YellowSplat>.entities.size() >= ECS::registry<BlueSplat>.entities.size())
-            {
-                winner_colour = "Yellow";
-            }
+            score_text_version = score_version;
+            score_text_turn = current_turn;
+            score_text_player = active_player;
 
-            else if (ECS::registry<GreenSplat>.entities.size() >= ECS::registry<YellowSplat>.entities.size() && ECS::registry<GreenSplat>.entities.size() >= ECS::registry<RedSplat>.entities.size() && ECS::registry<GreenSplat>.entities.size() >= ECS::registry<BlueSplat>.entities.size())
-            {
-                winner_colour = "Green";
-            }
+            std::stringstream scores;
+            std::stringstream current_player;
 
-            else if (ECS::registry<RedSplat>.entities.size() >= ECS::registry<YellowSplat>.entities.size() && ECS::registry<RedSplat>.entities.size() >= ECS::registry<GreenSplat>.entities.size() && ECS::registry<RedSplat>.entities.size() >= ECS::registry<BlueSplat>.entities.size())
-            {
-                winner_colour = "Red";
-            }
-        }
+            std::string winner_colour = "Blue";
 
-        if (ECS::registry<Egg>.components.size() < MAX_EGGS && next_egg_spawn == 0)
-        {
-            next_egg_spawn = 3;
-            auto& motion = ECS::registry<Motion>.get(islandGrid[numWidth / 2][numHeight / 2]);
-            ECS::Entity entity = Egg::createEgg(motion.position);
-        }
+            if (current_turn == MAX_TURNS)
+            {
+                if (ECS::registry<YellowSplat>().size() >= ECS::registry<GreenSplat>().size() && ECS::registry<YellowSplat>().size() >= ECS::registry<RedSplat>().size() && ECS::registry<YellowSplat>().size() >= ECS::registry<BlueSplat>().size())
+                {
+                    winner_colour = "Yellow";
+                }
 
-        scores <<
-            "Yellow: " << ECS::registry<YellowSplat>.entities.size() <<
-            " Green: " << ECS::registry<GreenSplat>.entities.size() <<
-            " Red: " << ECS::registry<RedSplat>.entities.size() <<
-            " Blue: " << ECS::registry<BlueSplat>.entities.size();
-        current_turn == MAX_TURNS ? current_player << "And the winner is: " << winner_colour << "!" : current_player << "Current Player: " << active_colour << " Round: " << 1 + current_turn / 4;
+                else if (ECS::registry<GreenSplat>().size() >= ECS::registry<YellowSplat>().size() && ECS::registry<GreenSplat>().size() >= ECS::registry<RedSplat>().size() && ECS::registry<GreenSplat>().size() >= ECS::registry<BlueSplat>().size())
+                {
+                    winner_colour = "Green";
+                }
 
-        if (ECS::registry<Text>.size() > 0) {
-            ECS::registry<Text>.get(score_text).content = scores.str();
-            ECS::registry<Text>.get(player_text).content = current_player.str();
-        }
+                else if (ECS::registry<RedSplat>().size() >= ECS::registry<YellowSplat>().size() && ECS::registry<RedSplat>().size() >= ECS::registry<GreenSplat>().size() && ECS::registry<RedSplat>().size() >= ECS::registry<BlueSplat>().size())
+                {
+                    winner_colour = "Red";
+                }
+            }
 
-        // Friction implementation
-        for (auto& blob : ECS::registry<Blobule>.entities)
-        {
-            auto& motion = ECS::registry<Motion>.get(blob);
-            motion.velocity += -motion.velocity * motion.friction;
+            scores <<
+                "Yellow: " << ECS::registry<YellowSplat>().size() <<
+                " Green: " << ECS::registry<GreenSplat>().size() <<
+                " Red: " << ECS::registry<RedSplat>().size() <<
+                " Blue: " << ECS::registry<BlueSplat>().size();
+            current_turn == MAX_TURNS ? current_player << "And the winner is: " << winner_colour << "!" : current_player << "Current Player: " << active_colour << " Round: " << 1 + current_turn / 4;
 
-            float velocityMagnitude = Utils::getVelocityMagnitude(motion);
-            if (velocityMagnitude < terminalVelocity) {
-                motion.velocity = { 0.f, 0.f };
+            if (ECS::registry<Text>().size() > 0) {
+                ECS::registry<Text>().patch(score_text).content = scores.str();
+                ECS::registry<Text>().patch(player_text).content = current_player.str();
             }
         }
+    }
+}
+
+void WorldSystem::update_turn(vec2 window_size_in_game_units)
+{
+    ECS::World::Scope scope(world);
+    if (gameState == GameState::Game) {
+        // Switch Player Statement
+        std::string end_turn_message = "Press Enter to End Your Turn";
+
+        // Friction is part of the RigidBody integration in PhysicsSystem::step
 
         if (blobuleMoved && noBlobulesMoving())
         {
-            ECS::registry<Text>.get(end_turn_text).content = end_turn_message;
+            ECS::registry<Text>().get(end_turn_text).content = end_turn_message;
             canPressEnter = true;
         }
         else
         {
-            ECS::registry<Text>.get(end_turn_text).content = "";
-            ECS::registry<Text>.get(end_turn_text).content = "";
-            auto& motion = ECS::registry<Motion>.get(active_player);
+            ECS::registry<Text>().get(end_turn_text).content = "";
+            ECS::registry<Text>().get(end_turn_text).content = "";
+            auto& motion = ECS::registry<Motion>().get(active_player);
             vec2 diff = vec2(window_size_in_game_units.x / 2, window_size_in_game_units.y / 2) - motion.position;
             if (motion.velocity.x != 0 && motion.velocity.y != 0) {
                 Utils::moveCamera(diff.x, diff.y);
@@ -292,6 +313,7 @@ void WorldSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
 
 // Reset the world state to its initial state
 void WorldSystem::restart() {
+    ECS::World::Scope scope(world);
 //    cap.open("/Users/vincent/Tile-Island/data/video/tutorial.mp4");
 //    if(!cap.isOpened())
 //    {
@@ -302,16 +324,9 @@ void WorldSystem::restart() {
     glfwGetWindowSize(window, &window_width, &window_height);
     should_restart_game = false;
 
-    // Remove all entities that we created (those that have a motion component)
-    while (ECS::registry<Motion>.entities.size() > 0)
-        ECS::ContainerInterface::remove_all_components_of(ECS::registry<Motion>.entities.back());
-
-    while (ECS::registry<ShadedMeshRef>.entities.size() > 0)
-        ECS::ContainerInterface::remove_all_components_of(ECS::registry<ShadedMeshRef>.entities.back());
-
-    // Remove buttons and text completely
-    ECS::registry<Button>.clear();
-    ECS::registry<Text>.clear();
+    // Remove all entities that the previous level or menu created, everything created from here on belongs to the new one
+    ECS::ContainerInterface::end_level();
+    ECS::ContainerInterface::begin_level();
 
 	if (gameState == GameState::Start) {
         should_go_to_main_menu = false;
@@ -360,16 +375,9 @@ void WorldSystem::restart() {
         current_turn = 0;
         MAX_TURNS = 20;
 
-        // Remove all entities that we created (those that have a motion component)
-        while (ECS::registry<Motion>.entities.size() > 0)
-            ECS::ContainerInterface::remove_all_components_of(ECS::registry<Motion>.entities.back());
-
-        while (ECS::registry<ShadedMeshRef>.entities.size() > 0)
-            ECS::ContainerInterface::remove_all_components_of(ECS::registry<ShadedMeshRef>.entities.back());
-
-
         // Debugging for memory/component leaks
-        ECS::ContainerInterface::list_all_components();
+        if (DebugSystem::in_debug_mode)
+            DebugSystem::printComponentStats();
 
         // Can replace loadMap with loadSavedMap
         islandGrid = MapLoader::loadMap(load_map_location, { window_width, window_height });
@@ -381,12 +389,10 @@ void WorldSystem::restart() {
         current_turn = vals[1];
         playerMove = vals[0];
         active_player = MapLoader::getBlobule(playerMove);
-        ECS::registry<Blobule>.get(active_player).active_player = true;
+        ECS::registry<Blobule>().get(active_player).active_player = true;
 
         // Clearing Text from previous game
-        if (ECS::registry<Text>.components.size() > 0) {
-            ECS::registry<Text>.clear();
-        }
+        destroyAllText();
 
         // initializing text
         score_text = Text::create_text("score", { 82, 60 }, font_size);
@@ -395,7 +401,7 @@ void WorldSystem::restart() {
         settings_button = Button::createButton({ window_size.x/15, window_size.y - 40 }, { 0.16,0.16 }, ButtonEnum::OpenSettings, "");
         help_button = Button::createButton({ window_size.x/1.07, window_size.y - 46 }, { 0.085,0.085 }, ButtonEnum::OpenHelp, "");
 
-        auto& motion = ECS::registry<Motion>.get(active_player);
+        auto& motion = ECS::registry<Motion>().get(active_player);
         vec2 diff = vec2(window_width / 2, window_height / 2) - motion.position;
         Utils::moveCamera(diff.x, diff.y);
     }
@@ -409,14 +415,14 @@ void WorldSystem::restart() {
 
         // Add blobules to the LevelEditor context
         LevelEditor::clear_entity_lists();
-        for (ECS::Entity blobule : ECS::registry<Blobule>.entities)
+        for (ECS::Entity blobule : ECS::registry<Blobule>().entities)
         {
             LevelEditor::add_blobule(blobule);
         }
 
         // Create clickable tiles + egg at bottom of the screen
-        Motion& leftmost_tile = ECS::registry<Motion>.get(islandGrid[0][0]);
-        Motion& rightmost_tile = ECS::registry<Motion>.get(islandGrid[0][islandGrid[0].size() - 1]);
+        Motion& leftmost_tile = ECS::registry<Motion>().get(islandGrid[0][0]);
+        Motion& rightmost_tile = ECS::registry<Motion>().get(islandGrid[0][islandGrid[0].size() - 1]);
         float bottom_of_window = window_height - 50.f;
         editor_water = Tile::createTile({ leftmost_tile.position.x, bottom_of_window }, TerrainType::Water_Old);
         editor_block = Tile::createTile({ leftmost_tile.position.x + 50.f, bottom_of_window }, TerrainType::Block);
@@ -461,7 +467,7 @@ void WorldSystem::enable_settings(bool enable)
     }
     else {
         settings_is_active = false;
-        ECS::ContainerInterface::remove_all_components_of(settings_tool);
+        ECS::ContainerInterface::destroy_entity(settings_tool);
     }
 }
 
@@ -473,7 +479,7 @@ void WorldSystem::enable_help(bool enable)
     }
     else {
         help_tool_is_active = false;
-        ECS::ContainerInterface::remove_all_components_of(help_tool);
+        ECS::ContainerInterface::destroy_entity(help_tool);
     }
 }
 
@@ -511,11 +517,9 @@ void WorldSystem::set_load_map_location(std::string loc)
 // Check out https://www.glfw.org/docs/3.3/input_guide.html
 void WorldSystem::on_key(int key, int, int action, int mod)
 {
+    ECS::World::Scope scope(world);
     if (gameState == GameState::Game)
     {
-        auto& blobule_movement = ECS::registry<Motion>.get(active_player);
-        auto blobule_position = blobule_movement.position;
-
         // For when you press a WASD key and the camera starts moving.
         if (action == GLFW_PRESS || action == GLFW_REPEAT)
         {
@@ -546,9 +550,9 @@ void WorldSystem::on_key(int key, int, int action, int mod)
         if (action == GLFW_PRESS && key == GLFW_KEY_ENTER && current_turn < MAX_TURNS && canPressEnter)
         {
             // Replace current highlighted blobule with unhighlighted blobule.
-            std::string active_colour = ECS::registry<Blobule>.get(active_player).color;
-            blobuleCol col = ECS::registry<Blobule>.get(active_player).colEnum;
-            ECS::registry<ShadedMeshRef>.remove(active_player);
+            std::string active_colour = ECS::registry<Blobule>().get(active_player).color;
+            blobuleCol col = ECS::registry<Blobule>().get(active_player).colEnum;
+            ECS::registry<ShadedMeshRef>().remove(active_player);
 
             std::string key = "blobule_after_highlight_" + active_colour;
             ShadedMesh& resource = cache_resource(key);
@@ -576,7 +580,7 @@ void WorldSystem::on_key(int key, int, int action, int mod)
                 }
                 RenderSystem::createSprite(resource, path, "textured");
             }
-            ECS::registry<ShadedMeshRef>.emplace(active_player, resource);
+            ECS::registry<ShadedMeshRef>().emplace(active_player, resource);
 
             // Update active player.
             if (playerMove != 3) {
@@ -590,9 +594,9 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 
             // Replace next unhighlighted blobule with highlighted blobule.
             active_player = MapLoader::getBlobule(playerMove);
-            std::string active_colour2 = ECS::registry<Blobule>.get(active_player).color;
-            blobuleCol col2 = ECS::registry<Blobule>.get(active_player).colEnum;
-            ECS::registry<ShadedMeshRef>.remove(active_player);
+            std::string active_colour2 = ECS::registry<Blobule>().get(active_player).color;
+            blobuleCol col2 = ECS::registry<Blobule>().get(active_player).colEnum;
+            ECS::registry<ShadedMeshRef>().remove(active_player);
 
             std::string key2 = "blobule_before_highlight_" + active_colour2;
             ShadedMesh& resource2 = cache_resource(key2);
@@ -620,15 +624,15 @@ void WorldSystem::on_key(int key, int, int action, int mod)
                 }
                 RenderSystem::createSprite(resource2, path, "textured");
             }
-            ECS::registry<ShadedMeshRef>.emplace(active_player, resource2);
+            ECS::registry<ShadedMeshRef>().emplace(active_player, resource2);
 
-            ECS::registry<Blobule>.get(active_player).active_player = false;
+            ECS::registry<Blobule>().get(active_player).active_player = false;
             active_player = MapLoader::getBlobule(playerMove);
 
 
-            ECS::registry<Blobule>.get(active_player).active_player = true;
+            ECS::registry<Blobule>().get(active_player).active_player = true;
 
-            if (ECS::registry<Egg>.components.size() < MAX_EGGS)
+            if (ECS::registry<Egg>().components.size() < MAX_EGGS)
             {
                 next_egg_spawn--;
                 if (next_egg_spawn < 0)
@@ -637,7 +641,7 @@ void WorldSystem::on_key(int key, int, int action, int mod)
             canPressEnter = false;
             blobuleMoved = false;
 
-            auto& motion = ECS::registry<Motion>.get(active_player);
+            auto& motion = ECS::registry<Motion>().get(active_player);
             int window_width, window_height;
             glfwGetWindowSize(window, &window_width, &window_height);
             vec2 diff = vec2(window_width / 2, window_height / 2) - motion.position;
@@ -658,19 +662,24 @@ void WorldSystem::on_key(int key, int, int action, int mod)
                 DebugSystem::clearDebugComponents();
             }
         }
+        if (key == GLFW_KEY_J && action == GLFW_PRESS && DebugSystem::in_debug_mode)
+        {
+            DebugSystem::saveComponentStats("ecs_stats.json");
+        }
     }
 }
 
 // On mouse move callback
 void WorldSystem::on_mouse_move(vec2 mouse_pos)
 {
+    ECS::World::Scope scope(world);
     // Do not continue if not in Game state
     if (gameState != GameState::Game)
         return;
 
-	if (ECS::registry<Blobule>.has(active_player) && mouse_move)
+	if (ECS::registry<Blobule>().has(active_player) && mouse_move)
 	{
-		auto& blobMotion = ECS::registry<Motion>.get(active_player);
+		auto& blobMotion = ECS::registry<Motion>().get(active_player);
 		blobMotion.angle = atan2(mouse_pos.y - mouse_press_y, mouse_pos.x - mouse_press_x) - PI;
 		float dragDistance = (((mouse_pos.y - mouse_press_y) * (mouse_pos.y - mouse_press_y)) + ((mouse_pos.x - mouse_press_x) * (mouse_pos.x - mouse_press_x))) * 0.01;
         if (dragDistance > 30.f)
@@ -685,6 +694,7 @@ void WorldSystem::on_mouse_move(vec2 mouse_pos)
 // On mouse button callback
 void WorldSystem::on_mouse_button(GLFWwindow* wnd, int button, int action)
 {
+    ECS::World::Scope scope(world);
 	glfwGetCursorPos(wnd, &mouse_press_x, &mouse_press_y);
     // Handle clicks for start menu
 	if (gameState == GameState::Start)
@@ -697,22 +707,22 @@ void WorldSystem::on_mouse_button(GLFWwindow* wnd, int button, int action)
             if (start_clicked) {
                 Mix_PlayChannel(-1, game_start_sound, 0);
                 gameState = GameState::Intro;
-                ECS::registry<Button>.clear();
-                ECS::registry<Text>.clear();
+                ECS::registry<Button>().clear();
+                destroyAllText();
                 should_restart_game = true;
             }
             else if (load_clicked) {
                 Mix_PlayChannel(-1, game_start_sound, 0);
                 gameState = GameState::Game;
                 set_load_map_location("data/saved/map.json");
-                ECS::registry<Button>.clear();
-                ECS::registry<Text>.clear();
+                ECS::registry<Button>().clear();
+                destroyAllText();
                 should_restart_game = true;
             }
             else if (level_editor_clicked) {
                 gameState = GameState::LevelEditor;
-                ECS::registry<Button>.clear();
-                ECS::registry<Text>.clear();
+                ECS::registry<Button>().clear();
+                destroyAllText();
                 restart();
             }
             else if (quit_clicked) {
@@ -730,7 +740,7 @@ void WorldSystem::on_mouse_button(GLFWwindow* wnd, int button, int action)
                     Mix_PlayChannel(-1, game_start_sound, 0);
                     gameState = GameState::Game;
                     set_load_map_location(buttonPair.first);
-                    ECS::registry<Text>.clear();
+                    destroyAllText();
                     should_restart_game = true;
                     break;
                 }
@@ -759,7 +769,7 @@ void WorldSystem::on_mouse_button(GLFWwindow* wnd, int button, int action)
                 mouse_move = false;
                 isDraggedFarEnough = false;
 
-                auto& blobMotion = ECS::registry<Motion>.get(active_player);
+                auto& blobMotion = ECS::registry<Motion>().get(active_player);
                 float blobAngle = blobMotion.angle;
                 float blobPower = blobMotion.dragDistance;
 
@@ -767,7 +777,7 @@ void WorldSystem::on_mouse_button(GLFWwindow* wnd, int button, int action)
 
                 float velocityMagnitude = Utils::getVelocityMagnitude(blobMotion);
 
-                std::string active_colour = ECS::registry<Blobule>.get(active_player).color;
+                std::string active_colour = ECS::registry<Blobule>().get(active_player).color;
                 if (active_colour == "blue"){
                     if (velocityMagnitude > max_blue_speed) {
                         blobMotion.velocity = { cos(blobAngle) * max_blue_speed, sin(blobAngle) * max_blue_speed };
@@ -819,8 +829,8 @@ void WorldSystem::on_mouse_button(GLFWwindow* wnd, int button, int action)
         if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
         {
             // Check if the click is within in the map
-            Motion& first_tile_motion = ECS::registry<Motion>.get(islandGrid[0][0]);
-            Motion& last_tile_motion = ECS::registry<Motion>.get(islandGrid[islandGrid.size() - 1][islandGrid[0].size() - 1]);
+            Motion& first_tile_motion = ECS::registry<Motion>().get(islandGrid[0][0]);
+            Motion& last_tile_motion = ECS::registry<Motion>().get(islandGrid[islandGrid.size() - 1][islandGrid[0].size() - 1]);
             vec2 top_left = { first_tile_motion.position.x - first_tile_motion.scale.x / 2, first_tile_motion.position.y - first_tile_motion.scale.y / 2 };
             vec2 bottom_right = { last_tile_motion.position.x + last_tile_motion.scale.x / 2, last_tile_motion.position.y + last_tile_motion.scale.y / 2 };
 
@@ -923,7 +933,7 @@ void WorldSystem::on_mouse_button(GLFWwindow* wnd, int button, int action)
             case GameState::Tutorial:
                 break;
             }
-            ECS::registry<Text>.clear();
+            destroyAllText();
             restart();
         }
     }
@@ -18,8 +18,8 @@
 class WorldSystem
 {
 public:
-	// Creates a window
-	WorldSystem(ivec2 window_size_px);
+	// Creates a window for the game in world
+	WorldSystem(ivec2 window_size_px, ECS::World& world = ECS::World::main());
 
 	// Releases all associated resources
 	~WorldSystem();
@@ -27,8 +27,12 @@ public:
 	// restart level
 	void restart();
 
-	// Steps the game ahead by ms milliseconds
-	void step(float elapsed_ms, vec2 window_size_in_game_units);
+	// Restarts the level if the menus asked for it, call it before the systems run
+	void restart_if_requested();
+	// Steps the game ahead by ms milliseconds, the eggs it spawns are created when commands are flushed
+	void step(float elapsed_ms, vec2 window_size_in_game_units, ECS::CommandBuffer& commands);
+	// Shows the end turn prompt once all blobules stopped, until then keeps the camera on the moving active player
+	void update_turn(vec2 window_size_in_game_units);
 
 	// Check for collisions
 	void handle_collisions();
@@ -55,6 +59,9 @@ public:
 	static void set_load_map_location(std::string loc);
 
 private:
+	// The entities and components the game runs on, current while any member function runs
+	ECS::World& world;
+
 	// Input callback functions
 	void on_key(int key, int, int action, int mod);
 	void on_mouse_move(vec2 mouse_pos);
@@ -77,6 +84,11 @@ private:
 	ECS::Entity player_text;
 	ECS::Entity end_turn_text;
 
+	// What the score and player texts were last built from
+	unsigned long long score_text_version = ~0ull;
+	int score_text_turn = -1;
+	ECS::Entity score_text_player = ECS::Entity::null();
+
 	ECS::Entity start_button;
 	ECS::Entity load_button;
 	ECS::Entity level_editor_button;
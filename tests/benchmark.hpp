@@ -0,0 +1,31 @@
+// Timing helper shared by the benchmarks in this directory, which print their results rather than checking them
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// Fastest of several runs of f in milliseconds, the minimum is the least disturbed by the rest of the system
+template <typename Function>
+double best_of_ms(int runs, Function f)
+{
+	double best = std::numeric_limits<double>::max();
+	for (int run = 0; run < runs; run++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		f();
+		const auto end = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+	}
+	return best;
+}
+
+// Keeps the compiler from dropping a computation whose result is otherwise unused
+template <typename T>
+inline volatile T kept_value{};
+
+template <typename T>
+void keep(T value)
+{
+	kept_value<T> = value;
+}
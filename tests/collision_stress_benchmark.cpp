@@ -0,0 +1,153 @@
+// Steps PhysicsSystem on a crowded island with hundreds of blobules and eggs, and compares the SSE2 circle overlap kernel
+// that finds the body pairs for the narrowphase against testing one circle at a time
+#include "physics.hpp"
+#include "blobule.hpp"
+#include "egg.hpp"
+#include "tile.hpp"
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+namespace {
+
+const int island_width = 40; // in tiles
+const int island_height = 30;
+const vec2 island_origin = { 0.f, 0.f };
+const float blobule_size = 30.f;
+const vec2 egg_size = { 45.f, 55.f };
+const int steps = 50;
+const int kernel_rounds = 20;
+const int runs = 5;
+
+// Mud ground, walled in by Block tiles
+void create_island()
+{
+	for (int y = 0; y < island_height; y++)
+	{
+		for (int x = 0; x < island_width; x++)
+		{
+			ECS::Entity tile;
+			ECS::registry<Tile>().emplace(tile);
+			auto& motion = ECS::registry<Motion>().emplace(tile);
+			motion.position = island_origin + vec2(x, y) * tileSize;
+			motion.scale = { tileSize, tileSize };
+			const bool wall = x == 0 || y == 0 || x == island_width - 1 || y == island_height - 1;
+			ECS::registry<Terrain>().emplace(tile).type = wall ? Block : Mud;
+		}
+	}
+}
+
+// Kinematic bodies keep their velocity, such that the scene stays busy for every step
+void create_body(ECS::Entity entity, vec2 position, vec2 velocity)
+{
+	auto& motion = ECS::registry<Motion>().emplace(entity);
+	motion.position = position;
+	motion.velocity = velocity;
+	auto& body = ECS::registry<RigidBody>().emplace(entity);
+	body.type = BodyType::Kinematic;
+	body.previous_position = position;
+}
+
+// Two blobules for every egg, scattered inside the walls
+void create_bodies(unsigned int count, std::mt19937& random)
+{
+	std::uniform_real_distribution<float> x(2.f * tileSize, (island_width - 3) * tileSize);
+	std::uniform_real_distribution<float> y(2.f * tileSize, (island_height - 3) * tileSize);
+	std::uniform_real_distribution<float> speed(-200.f, 200.f);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		ECS::Entity entity;
+		create_body(entity, island_origin + vec2(x(random), y(random)), { speed(random), speed(random) });
+		auto& motion = ECS::registry<Motion>().get(entity);
+		if (i % 3 == 2)
+		{
+			ECS::registry<Egg>().emplace(entity);
+			motion.scale = egg_size;
+			motion.shape = Shape::egg;
+		}
+		else
+		{
+			ECS::registry<Blobule>().emplace(entity);
+			motion.scale = { blobule_size, blobule_size };
+			motion.shape = Shape::circle;
+		}
+	}
+}
+
+void destroy_bodies()
+{
+	std::vector<ECS::Entity> bodies = ECS::registry<Blobule>().entities;
+	bodies.insert(bodies.end(), ECS::registry<Egg>().entities.begin(), ECS::registry<Egg>().entities.end());
+	ECS::ContainerInterface::destroy_entities(bodies);
+}
+
+using Kernel = void (*)(unsigned int, const float*, const float*, const float*, unsigned int, std::vector<std::pair<unsigned int, unsigned int>>&);
+
+// One broadphase pass as PhysicsSystem::step runs it, every body against the bodies after it
+void find_pairs(Kernel kernel, const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& radius,
+	std::vector<std::pair<unsigned int, unsigned int>>& pairs)
+{
+	pairs.clear();
+	const unsigned int count = static_cast<unsigned int>(x.size());
+	for (unsigned int i = 0; i < count; i++)
+		kernel(i, x.data(), y.data(), radius.data(), count, pairs);
+}
+
+}
+
+int main()
+{
+	create_island();
+	std::mt19937 random(42);
+
+	std::cout << island_width * island_height << " tiles" << std::endl;
+	for (unsigned int body_count : { 150u, 300u, 600u, 1200u })
+	{
+		create_bodies(body_count, random);
+
+		PhysicsSystem physics;
+		size_t contacts = 0;
+		const double step_ms = best_of_ms(runs, [&]() {
+			for (int step = 0; step < steps; step++)
+			{
+				physics.step(simulation_step_ms, { 1200.f, 900.f });
+				contacts = physics.contacts.contacts().size();
+			}
+		}) / steps;
+
+		// The bounding circles of the bodies where the steps left them, eggs with the circle around their scale
+		std::vector<float> x, y, radius;
+		for (auto entities : { &ECS::registry<Blobule>().entities, &ECS::registry<Egg>().entities })
+		{
+			for (ECS::Entity entity : *entities)
+			{
+				const Motion& motion = ECS::registry<Motion>().get(entity);
+				x.push_back(motion.position.x);
+				y.push_back(motion.position.y);
+				radius.push_back(glm::length(motion.scale) / 2.f);
+			}
+		}
+		std::vector<std::pair<unsigned int, unsigned int>> pairs, scalar_pairs;
+		const double kernel_ms = best_of_ms(runs, [&]() {
+			for (int round = 0; round < kernel_rounds; round++)
+				find_pairs(overlapping_circles, x, y, radius, pairs);
+		}) / kernel_rounds;
+		const double scalar_ms = best_of_ms(runs, [&]() {
+			for (int round = 0; round < kernel_rounds; round++)
+				find_pairs(overlapping_circles_scalar, x, y, radius, scalar_pairs);
+		}) / kernel_rounds;
+		if (pairs != scalar_pairs)
+		{
+			std::cerr << "The kernels found different pairs for " << body_count << " bodies" << std::endl;
+			return 1;
+		}
+
+		std::cout << "  " << body_count << " bodies: step " << step_ms << " ms with " << contacts << " contacts, broadphase "
+			<< pairs.size() << " pairs in " << kernel_ms * 1000.0 << " us, one circle at a time " << scalar_ms * 1000.0
+			<< " us (" << scalar_ms / kernel_ms << "x)" << std::endl;
+		destroy_bodies();
+	}
+	return 0;
+}
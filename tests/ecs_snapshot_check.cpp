@@ -0,0 +1,144 @@
+// Round trip of ECS::snapshot() and ECS::restore(): snapshot, mutate, restore, and compare ids and components
+#include "tiny_ecs.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		std::cerr << "FAILED: " << what << std::endl;
+		failures++;
+	}
+}
+
+// One component per way a container is stored in a snapshot
+struct Position // trivially copyable, copied as a block
+{
+	float x = 0.f;
+	float y = 0.f;
+};
+
+struct Name // written through a Serializer
+{
+	std::string text;
+};
+
+struct Path // neither, copied into the snapshot as objects
+{
+	std::vector<int> points;
+};
+
+struct Marker {}; // tag, only the entities are stored
+
+struct Late // its container only exists after the snapshot was taken
+{
+	int value = 0;
+};
+
+template <typename Component>
+std::vector<unsigned int> ids_of()
+{
+	std::vector<unsigned int> ids;
+	// Tags keep no entity list
+	for (ECS::Entity e : std::is_empty<Component>::value ? ECS::registry<Component>().marked_entities() : ECS::registry<Component>().entities)
+		ids.push_back(e.id);
+	return ids;
+}
+
+}
+
+template <> struct ECS::Serializer<Name>
+{
+	static constexpr bool available = true;
+	static void write(ECS::SnapshotWriter& out, const Name& name) { out.write(name.text); }
+	static Name read(ECS::SnapshotReader& in)
+	{
+		Name name;
+		in.read(name.text);
+		return name;
+	}
+};
+
+int main()
+{
+	ECS::Entity first;
+	ECS::Entity second;
+	ECS::Entity third;
+	ECS::registry<Position>().emplace(first, Position{ 1.f, 2.f });
+	ECS::registry<Position>().emplace(second, Position{ 3.f, 4.f });
+	ECS::registry<Name>().emplace(first, Name{ "first" });
+	ECS::registry<Path>().emplace(second, Path{ { 1, 2, 3 } });
+	ECS::registry<Marker>().emplace(second);
+	ECS::registry<Marker>().emplace(third);
+	// Leaves a free index, such that the allocator state is not just a counter
+	ECS::ContainerInterface::destroy_entity(third);
+
+	const std::vector<unsigned int> position_ids = ids_of<Position>();
+	const std::vector<unsigned int> name_ids = ids_of<Name>();
+	const std::vector<unsigned int> path_ids = ids_of<Path>();
+	const std::vector<unsigned int> marker_ids = ids_of<Marker>();
+	const ECS::Snapshot snapshot = ECS::snapshot();
+
+	// The id the next entity gets after the snapshot, a restore has to hand it out again
+	ECS::Entity created_after;
+	ECS::registry<Position>().emplace(created_after, Position{ 5.f, 6.f });
+	ECS::registry<Position>().get(first).x = 100.f;
+	ECS::registry<Name>().get(first).text = "changed";
+	ECS::registry<Path>().get(second).points.push_back(4);
+	ECS::registry<Marker>().emplace(first);
+	ECS::ContainerInterface::destroy_entity(second);
+	const unsigned int expected_next_id = created_after.id;
+
+	for (int round = 0; round < 2; round++)
+	{
+		ECS::restore(snapshot);
+
+		check(ids_of<Position>() == position_ids, "Position entities are restored");
+		check(ids_of<Name>() == name_ids, "Name entities are restored");
+		check(ids_of<Path>() == path_ids, "Path entities are restored");
+		check(ids_of<Marker>() == marker_ids, "Marker entities are restored");
+		check(ECS::valid(first) && ECS::valid(second), "Entities destroyed after the snapshot are valid again");
+		check(!ECS::valid(third), "Entities destroyed before the snapshot stay invalid");
+		check(!ECS::registry<Position>().has(created_after), "Entities created after the snapshot have no components");
+
+		const Position& position = ECS::registry<Position>().get(first);
+		check(position.x == 1.f && position.y == 2.f, "Trivially copyable components are restored");
+		check(ECS::registry<Name>().get(first).text == "first", "Serialized components are restored");
+		check(ECS::registry<Path>().get(second).points == std::vector<int>{ 1, 2, 3 }, "Copied components are restored");
+		check(!ECS::registry<Marker>().has(first) && ECS::registry<Marker>().has(second), "Tag components are restored");
+
+		// The allocator is exactly what it was, so the next entity gets the same id as after the snapshot
+		ECS::Entity next;
+		check(next.id == expected_next_id, "The allocator is restored");
+		ECS::ContainerInterface::destroy_entity(next);
+	}
+
+	// A component type first used after the snapshot, on entities created after it, whose indices are past the
+	// signatures of the snapshot
+	{
+		ECS::ComponentContainer<Late> late;
+		std::vector<ECS::Entity> created(8);
+		for (unsigned int i = 0; i < created.size(); i++)
+			late.emplace(created[i], Late{ static_cast<int>(i) });
+		ECS::restore(snapshot);
+
+		check(late.size() == 0, "Component types first used after the snapshot are emptied");
+		bool unmarked = true;
+		for (ECS::Entity e : created)
+			unmarked = unmarked && !late.has(e) && ECS::ContainerInterface::signature_of(e).none();
+		check(unmarked, "Entities created after the snapshot have no signature");
+		check(ids_of<Position>() == position_ids, "Restoring with a new component type keeps the others");
+	}
+
+	if (failures > 0)
+		return 1;
+	std::cout << "ECS snapshot round trip passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,129 @@
+// Independence of ECS::World instances: worlds on separate threads hand out their own ids and keep their own components,
+// jobs run in the world of the thread that submitted them, and command buffers apply to the world they were recorded in
+#include "tiny_ecs.hpp"
+#include "jobs.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		std::cerr << "FAILED: " << what << std::endl;
+		failures++;
+	}
+}
+
+struct Position
+{
+	float x = 0.f;
+	float y = 0.f;
+};
+
+struct Marker {};
+
+// What one simulation saw of its world, compared across threads afterwards
+struct Outcome
+{
+	std::vector<unsigned int> ids;
+	size_t positions = 0;
+	size_t markers = 0;
+	float sum = 0.f;
+	bool restored = false;
+};
+
+// Builds and mutates a small scene, the same on every thread, such that independent worlds end up identical
+void simulate(ECS::World& world, Outcome& outcome)
+{
+	ECS::World::Scope scope(world);
+	std::vector<ECS::Entity> entities(100);
+	for (unsigned int i = 0; i < entities.size(); i++)
+	{
+		ECS::registry<Position>().emplace(entities[i], Position{ static_cast<float>(i), 1.f });
+		if (i % 2 == 0)
+			ECS::registry<Marker>().emplace(entities[i]);
+	}
+	// Re-used indices have to come from this world's free list
+	for (unsigned int i = 0; i < entities.size(); i += 10)
+		ECS::ContainerInterface::destroy_entity(entities[i]);
+	const ECS::Snapshot snapshot = ECS::snapshot();
+	for (unsigned int i = 0; i < 10; i++)
+		ECS::registry<Position>().emplace(ECS::Entity(), Position{ 1000.f, 0.f });
+	for (auto [entity, position] : ECS::view<Position>())
+		position.x += 1.f;
+
+	ECS::restore(snapshot);
+	outcome.restored = ECS::registry<Position>().size() == 90 && ECS::registry<Position>().get(entities[1]).x == 1.f;
+	for (auto [entity, position, marker] : ECS::view<Position, Marker>())
+		outcome.sum += position.x;
+	for (unsigned int i = 0; i < 5; i++)
+		outcome.ids.push_back(ECS::Entity().id);
+	outcome.positions = ECS::registry<Position>().size();
+	outcome.markers = ECS::registry<Marker>().size();
+}
+
+}
+
+int main()
+{
+	// The main world has content of its own that the other worlds must not see or change
+	ECS::Entity main_entity;
+	ECS::registry<Position>().emplace(main_entity, Position{ 42.f, 42.f });
+	const unsigned int main_next_id = ECS::Entity().id;
+
+	{
+		ECS::World first, second;
+		Outcome first_outcome, second_outcome;
+		std::thread first_thread([&]() { simulate(first, first_outcome); });
+		std::thread second_thread([&]() { simulate(second, second_outcome); });
+		first_thread.join();
+		second_thread.join();
+
+		check(first_outcome.restored && second_outcome.restored, "Every world restores its own snapshot");
+		check(first_outcome.ids == second_outcome.ids, "Worlds hand out ids independently");
+		check(first_outcome.positions == 90 && second_outcome.positions == 90, "Worlds keep their own components");
+		check(first_outcome.markers == 40 && second_outcome.markers == 40, "Worlds keep their own tags");
+		check(first_outcome.sum == second_outcome.sum, "Views only visit the components of their world");
+		check(&first.registry<Position>() != &second.registry<Position>(), "Every world has a container per component type");
+
+		// Jobs see the world of the thread that submitted them, also on the worker threads
+		JobSystem jobs(3);
+		std::atomic<unsigned int> wrong_world{ 0 };
+		std::atomic<unsigned int> visited{ 0 };
+		{
+			ECS::World::Scope scope(first);
+			jobs.parallel_for(ECS::registry<Position>(), 4, [&](ECS::Entity entity, Position&) {
+				if (&ECS::World::current() != &first || !ECS::registry<Position>().has(entity))
+					wrong_world++;
+				visited++;
+			});
+		}
+		check(wrong_world == 0 && visited == 90, "Jobs run in the world of the submitting thread");
+
+		// Commands recorded in a world apply to it, whichever world is current on flush
+		ECS::CommandBuffer commands;
+		ECS::Entity created = ECS::Entity::null();
+		{
+			ECS::World::Scope scope(second);
+			created = commands.create();
+			commands.emplace<Position>(created, Position{ 7.f, 7.f });
+		}
+		commands.flush();
+		check(second.registry<Position>().size() == 91 && !ECS::registry<Position>().has(created), "Command buffers apply to the world they were recorded in");
+	}
+
+	check(ECS::registry<Position>().size() == 1 && ECS::registry<Position>().get(main_entity).x == 42.f, "The main world is untouched");
+	check(ECS::Entity().id == main_next_id + 1, "The main world's allocator is untouched");
+
+	if (failures > 0)
+		return 1;
+	std::cout << "ECS world isolation passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,115 @@
+// Times the loops the game splits across the JobSystem on a large synthetic map, with 1, 2, 4 and 8 threads:
+// the tile loop of Utils::moveCamera, and TileGrid queries with a sweep test per body like PhysicsSystem's first impact search
+#include "physics.hpp"
+#include "tile.hpp"
+#include "utils.hpp"
+#include "jobs.hpp"
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <random>
+
+namespace {
+
+const int map_size = 400; // tiles per side
+const unsigned int body_count = 20000;
+const size_t tile_chunk_size = 128; // as in Utils::moveCamera
+const size_t body_chunk_size = 256; // as in PhysicsSystem::step
+const int frames = 20;
+const int runs = 5;
+
+void create_map()
+{
+	std::mt19937 random(42);
+	for (int y = 0; y < map_size; y++)
+	{
+		for (int x = 0; x < map_size; x++)
+		{
+			ECS::Entity entity;
+			auto& tile = ECS::registry<Tile>().emplace(entity);
+			auto& motion = ECS::registry<Motion>().emplace(entity);
+			motion.position = vec2(x, y) * tileSize;
+			motion.scale = { tileSize, tileSize };
+			// Every tenth tile blocks, the rest is open ground
+			ECS::registry<Terrain>().emplace(entity).type = random() % 10 == 0 ? Block : Speed;
+			tile.splatEntity = ECS::Entity();
+			ECS::registry<Motion>().emplace(tile.splatEntity).position = motion.position;
+		}
+	}
+}
+
+// The tile loop of Utils::moveCamera, every tile moves its own and its splat's Motion
+void move_tiles(JobSystem& jobs, vec2 offset)
+{
+	auto& motion_container = ECS::registry<Motion>();
+	jobs.parallel_for(ECS::registry<Tile>(), tile_chunk_size, [&](ECS::Entity entity, Tile& tile) {
+		motion_container.get(entity).position += offset;
+		motion_container.get(tile.splatEntity).position += offset;
+	});
+}
+
+// Earliest impact of every body with a Block tile along its movement, as clamp_to_first_impact finds it
+void sweep_bodies(JobSystem& jobs, const TileGrid& grid, const std::vector<vec2>& starts, const std::vector<vec2>& ends, std::vector<float>& impacts)
+{
+	jobs.parallel_for(starts.size(), body_chunk_size, [&](size_t begin, size_t end) {
+		const float radius = 15.f;
+		for (size_t i = begin; i < end; i++)
+		{
+			float first_toi = 1.f;
+			grid.query(glm::min(starts[i], ends[i]) - radius, glm::max(starts[i], ends[i]) + radius, [&](ECS::Entity tile, const Motion& tile_motion) {
+				if (ECS::registry<Terrain>().get(tile).type != Block)
+					return;
+				const vec2 half = tile_motion.scale / 2.f;
+				float toi;
+				if (Utils::sweepCircleAabb(starts[i], ends[i], radius, tile_motion.position - half, tile_motion.position + half, toi))
+					first_toi = std::min(first_toi, toi);
+			});
+			impacts[i] = first_toi;
+		}
+	});
+}
+
+}
+
+int main()
+{
+	create_map();
+	TileGrid grid;
+	grid.update();
+
+	// Bodies all over the map, each moving about two tiles in one step
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> coordinate(0.f, map_size * tileSize);
+	std::uniform_real_distribution<float> movement(-2.f * tileSize, 2.f * tileSize);
+	std::vector<vec2> starts, ends;
+	for (unsigned int i = 0; i < body_count; i++)
+	{
+		starts.push_back({ coordinate(random), coordinate(random) });
+		ends.push_back(starts.back() + vec2(movement(random), movement(random)));
+	}
+	std::vector<float> impacts(body_count);
+
+	std::cout << map_size * map_size << " tiles, " << body_count << " bodies, ms per frame (" << std::thread::hardware_concurrency() << " cores)" << std::endl;
+	double single_thread_ms[2] = { 0.0, 0.0 };
+	for (unsigned int threads : { 1u, 2u, 4u, 8u })
+	{
+		JobSystem jobs(threads - 1); // the calling thread is one of them
+		// Moving back and forth keeps the map where the grid expects it
+		const double move_ms = best_of_ms(runs, [&]() {
+			for (int frame = 0; frame < frames; frame++)
+				move_tiles(jobs, frame % 2 == 0 ? vec2(1.f, 0.f) : vec2(-1.f, 0.f));
+		}) / frames;
+		const double sweep_ms = best_of_ms(runs, [&]() {
+			for (int frame = 0; frame < frames; frame++)
+				sweep_bodies(jobs, grid, starts, ends, impacts);
+		}) / frames;
+		if (threads == 1)
+		{
+			single_thread_ms[0] = move_ms;
+			single_thread_ms[1] = sweep_ms;
+		}
+		std::cout << "  " << threads << " threads: camera move " << move_ms << " (" << single_thread_ms[0] / move_ms << "x), body sweeps "
+			<< sweep_ms << " (" << single_thread_ms[1] / sweep_ms << "x)" << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,73 @@
+// Compares ComponentContainer::get, which looks the entity up in a paged SparseIndex, against the std::unordered_map
+// from entity id to array index that the containers used before. Both resolve the same entities to the same components.
+#include "tiny_ecs.hpp"
+#include "benchmark.hpp"
+
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const unsigned int entity_count = 20000; // a large map's tiles plus their splats
+const int lookup_rounds = 50;
+const int runs = 5;
+
+struct Payload
+{
+	float value = 0.f;
+};
+
+// The previous lookup, a hash map next to the dense component array
+struct HashMapContainer
+{
+	std::unordered_map<unsigned int, unsigned int> map_entity_component_index;
+	std::vector<Payload> components;
+
+	Payload& get(ECS::Entity e) { return components[map_entity_component_index.find(e.id)->second]; }
+};
+
+template <typename Container>
+double lookups_ms(Container& container, const std::vector<ECS::Entity>& order)
+{
+	return best_of_ms(runs, [&]() {
+		float sum = 0.f;
+		for (int round = 0; round < lookup_rounds; round++)
+			for (ECS::Entity e : order)
+				sum += container.get(e).value;
+		keep(sum);
+	});
+}
+
+}
+
+int main()
+{
+	HashMapContainer hash_map;
+	std::vector<ECS::Entity> entities;
+	for (unsigned int i = 0; i < entity_count; i++)
+	{
+		ECS::Entity e;
+		entities.push_back(e);
+		ECS::registry<Payload>().emplace(e, Payload{ static_cast<float>(i) });
+		hash_map.map_entity_component_index[e.id] = i;
+		hash_map.components.push_back(Payload{ static_cast<float>(i) });
+	}
+
+	// Systems look entities up in the order of another container, which is mostly but not always the creation order
+	std::vector<ECS::Entity> shuffled = entities;
+	std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+
+	const double lookups = static_cast<double>(entity_count) * lookup_rounds;
+	std::cout << entity_count << " entities, " << lookup_rounds << " lookups each, ns per lookup" << std::endl;
+	for (const auto& [name, order] : { std::make_pair("in creation order", &entities), std::make_pair("shuffled", &shuffled) })
+	{
+		const double hash_map_ms = lookups_ms(hash_map, *order);
+		const double sparse_ms = lookups_ms(ECS::registry<Payload>(), *order);
+		std::cout << "  " << name << ": unordered_map " << hash_map_ms * 1e6 / lookups << ", SparseIndex " << sparse_ms * 1e6 / lookups
+			<< " (" << hash_map_ms / sparse_ms << "x)" << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,94 @@
+// Fires blobules at many angles and speeds from the middle of a ring of Block tiles one tile thick,
+// and checks that PhysicsSystem stops every one of them at the ring instead of letting it pass through
+#include "physics.hpp"
+#include "blobule.hpp"
+#include "tile.hpp"
+
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+const vec2 ring_center = { 500.f, 400.f };
+const int ring_radius = 4; // in tiles
+const float blobule_size = 30.f;
+const int angle_count = 120;
+const float speeds[] = { 250.f, 1000.f, 5000.f, 20000.f }; // px/s, from max_blobule_speed to well over a tile per step
+const float shot_ms = 2000.f; // long enough for the slowest shot to reach the ring
+
+void create_ring()
+{
+	for (int y = -ring_radius; y <= ring_radius; y++)
+	{
+		for (int x = -ring_radius; x <= ring_radius; x++)
+		{
+			if (std::abs(x) != ring_radius && std::abs(y) != ring_radius)
+				continue;
+			ECS::Entity tile;
+			ECS::registry<Tile>().emplace(tile);
+			auto& motion = ECS::registry<Motion>().emplace(tile);
+			motion.position = ring_center + vec2(x, y) * tileSize;
+			motion.scale = { tileSize, tileSize };
+			ECS::registry<Terrain>().emplace(tile).type = Block;
+		}
+	}
+}
+
+// Where the shot ends up, with the blobule stopped on its first contact
+vec2 fire(float angle, float speed)
+{
+	ECS::Entity blobule;
+	ECS::registry<Blobule>().emplace(blobule);
+	auto& motion = ECS::registry<Motion>().emplace(blobule);
+	motion.position = ring_center;
+	motion.scale = { blobule_size, blobule_size };
+	motion.shape = Shape::circle;
+	motion.velocity = vec2(std::cos(angle), std::sin(angle)) * speed;
+	// Kinematic, such that friction does not slow the shot down
+	auto& body = ECS::registry<RigidBody>().emplace(blobule);
+	body.type = BodyType::Kinematic;
+	body.previous_position = motion.position;
+
+	PhysicsSystem physics;
+	for (float elapsed_ms = 0.f; elapsed_ms < shot_ms; elapsed_ms += simulation_step_ms)
+	{
+		physics.step(simulation_step_ms, { 1000.f, 800.f });
+		for (const auto& contact : physics.contacts.contacts())
+		{
+			if (contact.phase != ContactPhase::end)
+				ECS::registry<Motion>().get(blobule).velocity = { 0.f, 0.f };
+		}
+	}
+	const vec2 end = ECS::registry<Motion>().get(blobule).position;
+	ECS::ContainerInterface::destroy_entity(blobule);
+	return end;
+}
+
+}
+
+int main()
+{
+	create_ring();
+
+	// The inner faces of the ring, a blobule may only end up 1 px into them
+	const float inner_extent = (ring_radius - 0.5f) * tileSize + 1.f;
+	int shots = 0;
+	int tunnelled = 0;
+	for (int i = 0; i < angle_count; i++)
+	{
+		const float angle = 2.f * PI * i / angle_count;
+		for (float speed : speeds)
+		{
+			const vec2 end = fire(angle, speed);
+			shots++;
+			if (std::abs(end.x - ring_center.x) > inner_extent || std::abs(end.y - ring_center.y) > inner_extent)
+			{
+				std::cerr << "Tunnelled at angle " << angle << " and speed " << speed << ", ended at " << end.x << ", " << end.y << std::endl;
+				tunnelled++;
+			}
+		}
+	}
+
+	std::cout << tunnelled << " of " << shots << " shots tunnelled" << std::endl;
+	return tunnelled == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+// Per-frame cost of the system loops over two components, e.g., Motion and Blobule in PhysicsSystem::step and Utils::moveCamera:
+// ECS::view against iterating one container and calling get() on every container for each of its entities
+#include "tiny_ecs.hpp"
+#include "benchmark.hpp"
+
+#include <iostream>
+
+namespace {
+
+const int frames = 200;
+const int runs = 15;
+
+// Stand-ins for Motion, which every entity has, and for the component that selects the entities a system handles
+struct Body
+{
+	float x = 0.f, y = 0.f;
+	float velocity_x = 1.f, velocity_y = 1.f;
+};
+
+struct Selected
+{
+	float speed = 1.f;
+};
+
+// The loop as the systems wrote it before views
+double lookup_loop_ms()
+{
+	return best_of_ms(runs, []() {
+		for (int frame = 0; frame < frames; frame++)
+		{
+			for (ECS::Entity e : ECS::registry<Selected>().entities)
+			{
+				Body& body = ECS::registry<Body>().get(e);
+				const Selected& selected = ECS::registry<Selected>().get(e);
+				body.x += body.velocity_x * selected.speed;
+				body.y += body.velocity_y * selected.speed;
+			}
+		}
+		keep(ECS::registry<Body>().components.back().x);
+	});
+}
+
+double view_loop_ms()
+{
+	return best_of_ms(runs, []() {
+		for (int frame = 0; frame < frames; frame++)
+		{
+			for (auto [e, body, selected] : ECS::view<Body, Selected>())
+			{
+				body.x += body.velocity_x * selected.speed;
+				body.y += body.velocity_y * selected.speed;
+			}
+		}
+		keep(ECS::registry<Body>().components.back().x);
+	});
+}
+
+}
+
+int main()
+{
+	// A large map: most entities are tiles with a Body only, a few hundred to all of them are selected
+	const unsigned int entity_count = 20000;
+	for (unsigned int i = 0; i < entity_count; i++)
+		ECS::registry<Body>().emplace(ECS::Entity());
+
+	std::cout << entity_count << " entities with a Body, ms per frame" << std::endl;
+	for (unsigned int selected_count : { 500u, 5000u, 20000u })
+	{
+		ECS::registry<Selected>().clear();
+		// Spread over the Body container, such that lookups do not walk memory in order
+		const unsigned int stride = entity_count / selected_count;
+		for (unsigned int i = 0; i < selected_count; i++)
+			ECS::registry<Selected>().emplace(ECS::registry<Body>().entities[i * stride]);
+
+		const double lookup_ms = lookup_loop_ms() / frames;
+		const double view_ms = view_loop_ms() / frames;
+		std::cout << "  " << selected_count << " selected: get() per entity " << lookup_ms << ", view " << view_ms
+			<< " (" << lookup_ms / view_ms << "x)" << std::endl;
+	}
+	return 0;
+}